@@ -0,0 +1,372 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "cachedevice.h"
+
+CacheDevice::CacheDevice(QIODevice *pDevice, qint32 nPageSize, qint32 nMaxPages, qint32 nMaxReadAhead, QObject *parent) : QIODevice(parent)
+{
+    if(nPageSize<=0)
+    {
+        nPageSize=0x1000;
+    }
+
+    if(nMaxPages<1)
+    {
+        nMaxPages=1;
+    }
+
+    if(nMaxReadAhead<1)
+    {
+        nMaxReadAhead=1;
+    }
+
+    if(nMaxReadAhead>nMaxPages)
+    {
+        nMaxReadAhead=nMaxPages;
+    }
+
+    this->pDevice=pDevice;
+    this->nSize=pDevice->size();
+    this->nPageSize=nPageSize;
+    this->nMaxPages=nMaxPages;
+    this->nMaxReadAhead=nMaxReadAhead;
+    this->nReadAhead=1;
+    this->nLastPage=-2;
+    this->pFirstPage=0;
+    this->pLastPage=0;
+
+    stats.nHits=0;
+    stats.nMisses=0;
+    stats.nReadAheadPages=0;
+    stats.nEvictedPages=0;
+}
+
+CacheDevice::~CacheDevice()
+{
+    if(isOpen())
+    {
+        close();
+    }
+
+    clearPages();
+}
+
+qint64 CacheDevice::size() const
+{
+    return nSize;
+}
+
+bool CacheDevice::isSequential() const
+{
+    return false;
+}
+
+bool CacheDevice::seek(qint64 pos)
+{
+    bool bResult=false;
+
+    if((pos<=nSize)&&(pos>=0))
+    {
+        bResult=QIODevice::seek(pos);
+    }
+
+    return bResult;
+}
+
+bool CacheDevice::reset()
+{
+    return seek(0);
+}
+
+bool CacheDevice::open(QIODevice::OpenMode mode)
+{
+    // Pages are the buffer; QIODevice must not keep its own
+    setOpenMode(mode|QIODevice::Unbuffered);
+
+    return true;
+}
+
+bool CacheDevice::atEnd() const
+{
+    return (pos()>=nSize);
+}
+
+void CacheDevice::close()
+{
+    clearPages();
+    setOpenMode(NotOpen);
+}
+
+QIODevice *CacheDevice::getOrigDevice()
+{
+    return pDevice;
+}
+
+CacheDevice::STATS CacheDevice::getStats()
+{
+    return stats;
+}
+
+bool CacheDevice::isCacheDevice(QIODevice *pDevice)
+{
+    bool bResult=false;
+
+    while(pDevice)
+    {
+        if(dynamic_cast<CacheDevice *>(pDevice))
+        {
+            bResult=true;
+
+            break;
+        }
+
+        SubDevice *pSubDevice=dynamic_cast<SubDevice *>(pDevice);
+
+        if(pSubDevice)
+        {
+            pDevice=pSubDevice->getOrigDevice();
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    return bResult;
+}
+
+qint64 CacheDevice::readData(char *data, qint64 maxSize)
+{
+    qint64 nResult=0;
+
+    qint64 nPos=pos();
+
+    maxSize=qMin(maxSize,nSize-nPos);
+
+    while(maxSize>0)
+    {
+        qint64 nPage=nPos/nPageSize;
+        qint64 nPageOffset=nPos%nPageSize;
+
+        const PAGE *pPage=getPage(nPage);
+
+        if(!pPage)
+        {
+            break;
+        }
+
+        qint64 nAvailable=pPage->baData.size()-nPageOffset;
+
+        if(nAvailable<=0)
+        {
+            break;
+        }
+
+        qint64 nCopy=qMin(maxSize,nAvailable);
+
+        memcpy(data,pPage->baData.constData()+nPageOffset,(size_t)nCopy);
+
+        data+=nCopy;
+        nPos+=nCopy;
+        nResult+=nCopy;
+        maxSize-=nCopy;
+    }
+
+    if((nResult==0)&&(maxSize>0))
+    {
+        nResult=-1;
+    }
+
+    return nResult;
+}
+
+qint64 CacheDevice::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data)
+    Q_UNUSED(maxSize)
+
+    return -1;
+}
+
+const CacheDevice::PAGE *CacheDevice::getPage(qint64 nPage)
+{
+    PAGE *pResult=mapPages.value(nPage);
+
+    if(pResult)
+    {
+        stats.nHits++;
+    }
+    else
+    {
+        stats.nMisses++;
+
+        // Parsers walk headers and tables forward; double the window while they keep doing so
+        if(nPage==nLastPage+1)
+        {
+            nReadAhead=qMin(nReadAhead*2,nMaxReadAhead);
+        }
+        else
+        {
+            nReadAhead=1;
+        }
+
+        loadPages(nPage,nReadAhead);
+
+        pResult=mapPages.value(nPage);
+    }
+
+    if(pResult)
+    {
+        if(pResult!=pFirstPage)
+        {
+            unlinkPage(pResult);
+            linkPage(pResult);
+        }
+
+        nLastPage=nPage;
+    }
+
+    return pResult;
+}
+
+void CacheDevice::loadPages(qint64 nPage, qint32 nCount)
+{
+    qint64 nPageCount=(nSize+nPageSize-1)/nPageSize;
+
+    // Do not read pages which are already cached
+    for(qint32 i=1;i<nCount;i++)
+    {
+        if((nPage+i>=nPageCount)||mapPages.contains(nPage+i))
+        {
+            nCount=i;
+
+            break;
+        }
+    }
+
+    qint64 nOffset=nPage*nPageSize;
+    qint64 nReadSize=qMin((qint64)nCount*nPageSize,nSize-nOffset);
+
+    if(nReadSize<=0)
+    {
+        return;
+    }
+
+    QByteArray baBuffer;
+    baBuffer.resize((int)nReadSize);
+
+    qint64 nRead=SubDevice::readAt(pDevice,nOffset,baBuffer.data(),nReadSize);
+
+    if(nRead<=0)
+    {
+        return;
+    }
+
+    for(qint32 i=0;i<nCount;i++)
+    {
+        qint64 nPageStart=(qint64)i*nPageSize;
+
+        if(nPageStart>=nRead)
+        {
+            break;
+        }
+
+        while(mapPages.count()>=nMaxPages)
+        {
+            evictPage();
+        }
+
+        PAGE *pPage=new PAGE;
+        pPage->nPage=nPage+i;
+        pPage->baData=baBuffer.mid((int)nPageStart,(int)qMin((qint64)nPageSize,nRead-nPageStart));
+
+        linkPage(pPage);
+        mapPages.insert(pPage->nPage,pPage);
+
+        if(i)
+        {
+            stats.nReadAheadPages++;
+        }
+    }
+}
+
+void CacheDevice::evictPage()
+{
+    PAGE *pPage=pLastPage;
+
+    if(pPage)
+    {
+        unlinkPage(pPage);
+        mapPages.remove(pPage->nPage);
+        delete pPage;
+
+        stats.nEvictedPages++;
+    }
+}
+
+void CacheDevice::linkPage(CacheDevice::PAGE *pPage)
+{
+    pPage->pPrev=0;
+    pPage->pNext=pFirstPage;
+
+    if(pFirstPage)
+    {
+        pFirstPage->pPrev=pPage;
+    }
+    else
+    {
+        pLastPage=pPage;
+    }
+
+    pFirstPage=pPage;
+}
+
+void CacheDevice::unlinkPage(CacheDevice::PAGE *pPage)
+{
+    if(pPage->pPrev)
+    {
+        pPage->pPrev->pNext=pPage->pNext;
+    }
+    else
+    {
+        pFirstPage=pPage->pNext;
+    }
+
+    if(pPage->pNext)
+    {
+        pPage->pNext->pPrev=pPage->pPrev;
+    }
+    else
+    {
+        pLastPage=pPage->pPrev;
+    }
+
+    pPage->pPrev=0;
+    pPage->pNext=0;
+}
+
+void CacheDevice::clearPages()
+{
+    qDeleteAll(mapPages);
+    mapPages.clear();
+
+    pFirstPage=0;
+    pLastPage=0;
+}
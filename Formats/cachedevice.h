@@ -0,0 +1,91 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef CACHEDEVICE_H
+#define CACHEDEVICE_H
+
+#include <QObject>
+#include <QIODevice>
+#include <QHash>
+#include "subdevice.h"
+
+// Read-only page cache over a device, for devices which are not in memory
+class CacheDevice : public QIODevice
+{
+public:
+    struct STATS
+    {
+        qint64 nHits;
+        qint64 nMisses;
+        qint64 nReadAheadPages;
+        qint64 nEvictedPages;
+    };
+
+    CacheDevice(QIODevice *pDevice,qint32 nPageSize=0x1000,qint32 nMaxPages=256,qint32 nMaxReadAhead=16,QObject *parent=0);
+    ~CacheDevice();
+
+    virtual qint64 size() const;
+    virtual bool isSequential() const;
+    virtual bool seek(qint64 pos);
+    virtual bool reset();
+    virtual bool open(OpenMode mode);
+    virtual bool atEnd() const;
+    virtual void close();
+
+    QIODevice *getOrigDevice();
+    STATS getStats();
+
+    static bool isCacheDevice(QIODevice *pDevice);
+
+protected:
+    virtual qint64 readData(char *data, qint64 maxSize);
+    virtual qint64 writeData(const char *data, qint64 maxSize);
+
+private:
+    // The pages are kept in use order: a hit moves its page to the front, a miss evicts the back
+    struct PAGE
+    {
+        qint64 nPage;
+        QByteArray baData;
+        PAGE *pPrev; // More recently used
+        PAGE *pNext; // Less recently used
+    };
+
+    const PAGE *getPage(qint64 nPage);
+    void loadPages(qint64 nPage,qint32 nCount);
+    void evictPage();
+    void linkPage(PAGE *pPage);
+    void unlinkPage(PAGE *pPage);
+    void clearPages();
+
+    QIODevice *pDevice;
+    qint64 nSize;
+    qint32 nPageSize;
+    qint32 nMaxPages;
+    qint32 nMaxReadAhead;
+    qint32 nReadAhead;
+    qint64 nLastPage;
+    QHash<qint64,PAGE *> mapPages;
+    PAGE *pFirstPage; // The most recently used
+    PAGE *pLastPage; // The next to evict
+    STATS stats;
+};
+
+#endif // CACHEDEVICE_H
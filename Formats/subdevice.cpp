@@ -20,6 +20,11 @@
 //
 #include "subdevice.h"
 
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#include <errno.h>
+#endif
+
 SubDevice::SubDevice(QIODevice *pDevice, qint64 nOffset, qint64 nSize, QObject *parent) : QIODevice(parent)
 {
     if(nOffset>pDevice->size())
@@ -45,9 +50,6 @@ SubDevice::SubDevice(QIODevice *pDevice, qint64 nOffset, qint64 nSize, QObject *
     this->pDevice=pDevice;
     this->nOffset=nOffset;
     this->nSize=nSize;
-
-    //    reset();
-    pDevice->seek(nOffset);
 }
 
 SubDevice::~SubDevice()
@@ -77,13 +79,10 @@ bool SubDevice::seek(qint64 pos)
 {
     bool bResult=false;
 
+    // The parent device is read with absolute offsets, so only the own position is moved
     if((pos<nSize)&&(pos>=0))
     {
-        if(pDevice->seek(nOffset+pos))
-        {
-            QIODevice::seek(pos);
-            bResult=true;
-        }
+        bResult=QIODevice::seek(pos);
     }
 
     return bResult;
@@ -96,7 +95,7 @@ bool SubDevice::reset()
 
 bool SubDevice::open(QIODevice::OpenMode mode)
 {
-    setOpenMode(mode);
+    setOpenMode(mode|QIODevice::Unbuffered);
 
     return true;
 }
@@ -113,14 +112,98 @@ void SubDevice::close()
 
 qint64 SubDevice::pos() const
 {
-    return pDevice->pos()-nOffset;
+    return QIODevice::pos();
+}
+
+QIODevice *SubDevice::getOrigDevice()
+{
+    return pDevice;
+}
+
+qint64 SubDevice::getInitOffset()
+{
+    return nOffset;
+}
+
+qint64 SubDevice::readAt(QIODevice *pDevice, qint64 nOffset, char *pData, qint64 nSize)
+{
+    qint64 nResult=0;
+
+    SubDevice *pSubDevice=dynamic_cast<SubDevice *>(pDevice);
+    QBuffer *pBuffer=qobject_cast<QBuffer *>(pDevice);
+    QFile *pFile=qobject_cast<QFile *>(pDevice);
+
+    if((nOffset<0)||(nSize<=0))
+    {
+        nResult=0;
+    }
+    else if(pSubDevice)
+    {
+        nSize=qMin(nSize,pSubDevice->nSize-nOffset);
+
+        if(nSize>0)
+        {
+            nResult=readAt(pSubDevice->pDevice,pSubDevice->nOffset+nOffset,pData,nSize);
+        }
+    }
+    else if(pBuffer&&(!(pBuffer->openMode()&QIODevice::WriteOnly)))
+    {
+        const QByteArray &baData=pBuffer->data();
+
+        nSize=qMin(nSize,(qint64)baData.size()-nOffset);
+
+        if(nSize>0)
+        {
+            memcpy(pData,baData.constData()+nOffset,(size_t)nSize);
+            nResult=nSize;
+        }
+    }
+#ifdef Q_OS_UNIX
+    else if(pFile&&(pFile->handle()!=-1)&&(!(pFile->openMode()&QIODevice::WriteOnly)))
+    {
+        // pread does not touch the file position, so one descriptor can be shared by readers
+        while(nResult<nSize)
+        {
+            ssize_t nRead=pread(pFile->handle(),pData+nResult,(size_t)(nSize-nResult),(off_t)(nOffset+nResult));
+
+            if(nRead>0)
+            {
+                nResult+=nRead;
+            }
+            else if((nRead==-1)&&(errno==EINTR))
+            {
+                continue;
+            }
+            else
+            {
+                if((nRead==-1)&&(nResult==0))
+                {
+                    nResult=-1;
+                }
+
+                break;
+            }
+        }
+    }
+#endif
+    else
+    {
+        Q_UNUSED(pFile)
+
+        if(pDevice->seek(nOffset))
+        {
+            nResult=pDevice->read(pData,nSize);
+        }
+    }
+
+    return nResult;
 }
 
 qint64 SubDevice::readData(char *data, qint64 maxSize)
 {
     maxSize=qMin(maxSize,nSize-pos());
 
-    qint64 nLen=pDevice->read(data,maxSize);
+    qint64 nLen=readAt(pDevice,nOffset+pos(),data,maxSize);
 
     return nLen;
 }
@@ -129,7 +212,12 @@ qint64 SubDevice::writeData(const char *data, qint64 maxSize)
 {
     maxSize=qMin(maxSize,nSize-pos());
 
-    qint64 nLen=pDevice->write(data,maxSize);
+    qint64 nLen=0;
+
+    if(pDevice->seek(nOffset+pos()))
+    {
+        nLen=pDevice->write(data,maxSize);
+    }
 
     return nLen;
 }
@@ -23,6 +23,8 @@
 
 #include <QObject>
 #include <QIODevice>
+#include <QBuffer>
+#include <QFile>
 
 class SubDevice : public QIODevice
 {
@@ -40,6 +42,11 @@ public:
     virtual void close();
     virtual qint64 pos() const;
 
+    QIODevice *getOrigDevice();
+    qint64 getInitOffset();
+
+    static qint64 readAt(QIODevice *pDevice,qint64 nOffset,char *pData,qint64 nSize);
+
 protected:
     virtual qint64 readData(char *data, qint64 maxSize);
     virtual qint64 writeData(const char *data, qint64 maxSize);
@@ -0,0 +1,201 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "xarena.h"
+
+#include <QThreadStorage>
+
+namespace
+{
+struct CURRENT
+{
+    XArena *pArena;
+
+    CURRENT() : pArena(nullptr)
+    {
+    }
+};
+
+// Values, not pointers: QThreadStorage would delete a pointer on thread exit
+QThreadStorage<CURRENT> g_currentArena;
+}
+
+const qint64 XARENA_ALIGNMENT=16;
+
+XArena::SCRATCH::SCRATCH(qint64 nSize)
+{
+    pArena=XArena::getCurrent();
+
+    if(pArena)
+    {
+        mark=pArena->getMark();
+        pData=pArena->allocate(nSize);
+    }
+    else
+    {
+        mark=MARK();
+        pData=new char[nSize];
+    }
+}
+
+XArena::SCRATCH::~SCRATCH()
+{
+    if(pArena)
+    {
+        pArena->rewind(mark);
+    }
+    else
+    {
+        delete[] pData;
+    }
+}
+
+char *XArena::SCRATCH::data()
+{
+    return pData;
+}
+
+XArena::XArena(qint64 nBlockSize)
+{
+    this->nBlockSize=nBlockSize;
+    this->nCurrentBlock=0;
+    this->nCurrentOffset=0;
+}
+
+XArena::~XArena()
+{
+    release();
+}
+
+char *XArena::allocate(qint64 nSize)
+{
+    nSize=(nSize+(XARENA_ALIGNMENT-1))&~(XARENA_ALIGNMENT-1);
+
+    if(nSize==0)
+    {
+        nSize=XARENA_ALIGNMENT;
+    }
+
+    // Blocks after the current one are left from a rewind and are used again
+    while(nCurrentBlock<listBlocks.count())
+    {
+        if(nCurrentOffset+nSize<=listBlocks.at(nCurrentBlock).nSize)
+        {
+            char *pResult=listBlocks.at(nCurrentBlock).pData+nCurrentOffset;
+            nCurrentOffset+=nSize;
+
+            return pResult;
+        }
+
+        nCurrentBlock++;
+        nCurrentOffset=0;
+    }
+
+    BLOCK block={};
+    block.nSize=qMax(nBlockSize,nSize);
+    block.pData=new char[block.nSize];
+
+    listBlocks.append(block);
+
+    nCurrentBlock=listBlocks.count()-1;
+    nCurrentOffset=nSize;
+
+    return block.pData;
+}
+
+XArena::MARK XArena::getMark()
+{
+    MARK result={};
+
+    result.nBlock=nCurrentBlock;
+    result.nOffset=nCurrentOffset;
+
+    return result;
+}
+
+void XArena::rewind(XArena::MARK mark)
+{
+    nCurrentBlock=mark.nBlock;
+    nCurrentOffset=mark.nOffset;
+}
+
+void XArena::release()
+{
+    int nCount=listBlocks.count();
+
+    for(int i=0; i<nCount; i++)
+    {
+        delete[] listBlocks.at(i).pData;
+    }
+
+    listBlocks.clear();
+
+    nCurrentBlock=0;
+    nCurrentOffset=0;
+}
+
+qint64 XArena::getBlocksSize()
+{
+    qint64 nResult=0;
+
+    int nCount=listBlocks.count();
+
+    for(int i=0; i<nCount; i++)
+    {
+        nResult+=listBlocks.at(i).nSize;
+    }
+
+    return nResult;
+}
+
+XArena *XArena::getCurrent()
+{
+    if(!g_currentArena.hasLocalData())
+    {
+        return nullptr;
+    }
+
+    return g_currentArena.localData().pArena;
+}
+
+void XArena::setCurrent(XArena *pArena)
+{
+    g_currentArena.localData().pArena=pArena;
+}
+
+XArenaScope::XArenaScope()
+{
+    pArena=nullptr;
+
+    if(!XArena::getCurrent())
+    {
+        pArena=new XArena;
+        XArena::setCurrent(pArena);
+    }
+}
+
+XArenaScope::~XArenaScope()
+{
+    if(pArena)
+    {
+        XArena::setCurrent(nullptr);
+        delete pArena;
+    }
+}
@@ -0,0 +1,96 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef XARENA_H
+#define XARENA_H
+
+#include <QtGlobal>
+#include <QList>
+
+// Monotonic allocator for the transient buffers of one scan.
+// Memory is taken from large blocks and given back in one step with release().
+// Every thread has its own current arena; without one the heap is used.
+class XArena
+{
+public:
+    struct MARK
+    {
+        qint32 nBlock;
+        qint64 nOffset;
+    };
+
+    // Scratch buffer from the current arena of the thread, freed in LIFO order
+    class SCRATCH
+    {
+    public:
+        explicit SCRATCH(qint64 nSize);
+        ~SCRATCH();
+
+        char *data();
+
+    private:
+        Q_DISABLE_COPY(SCRATCH)
+
+        XArena *pArena;
+        MARK mark;
+        char *pData;
+    };
+
+    explicit XArena(qint64 nBlockSize=0x40000);
+    ~XArena();
+
+    char *allocate(qint64 nSize); // Until release(); a SCRATCH that is alive frees it with its own buffer
+    MARK getMark();
+    void rewind(MARK mark);
+    void release();
+    qint64 getBlocksSize();
+
+    static XArena *getCurrent();
+    static void setCurrent(XArena *pArena);
+
+private:
+    Q_DISABLE_COPY(XArena)
+
+    struct BLOCK
+    {
+        char *pData;
+        qint64 nSize;
+    };
+
+    QList<BLOCK> listBlocks;
+    qint64 nBlockSize;
+    qint32 nCurrentBlock;
+    qint64 nCurrentOffset;
+};
+
+// Installs an arena as current for the scope, if the thread has none
+class XArenaScope
+{
+public:
+    XArenaScope();
+    ~XArenaScope();
+
+private:
+    Q_DISABLE_COPY(XArenaScope)
+
+    XArena *pArena;
+};
+
+#endif // XARENA_H
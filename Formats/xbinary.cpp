@@ -20,6 +20,17 @@
 //
 #include "xbinary.h"
 
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <dirent.h>
+#endif
+
+#if defined(__SSE2__)||defined(_M_X64)||(defined(_M_IX86_FP)&&(_M_IX86_FP>=2))
+#define XBINARY_SSE2
+#include <emmintrin.h>
+#endif
+
 XBinary::XBinary(QIODevice *__pDevice, bool bIsImage, qint64 nImageBase)
 {
     setData(__pDevice);
@@ -32,6 +43,12 @@ XBinary::XBinary(QIODevice *__pDevice, bool bIsImage, qint64 nImageBase)
 void XBinary::setData(QIODevice *__pDevice)
 {
     this->__pDevice=__pDevice;
+
+    // Reads from a read-only device in memory are plain copies
+    this->__pMemory=getDeviceMemory(__pDevice);
+    this->__nMemorySize=__pMemory?__pDevice->size():0;
+
+    _resetMemoryIndex();
 }
 
 qint64 XBinary::getSize()
@@ -150,18 +167,54 @@ void XBinary::findFiles(QString sDirectoryName, QList<QString> *pListFileNames)
 
 void XBinary::findFiles(QString sDirectoryName, XBinary::FFOPTIONS *pFFOption, qint32 nLevel)
 {
-    *(pFFOption->pnNumberOfFiles)=pFFOption->pListFiles->count();
-
     if(!(*pFFOption->pbIsStop))
     {
         QFileInfo fi(sDirectoryName);
 
         if(fi.isFile())
         {
-            pFFOption->pListFiles->append(fi.absoluteFilePath());
+            _findFilesAppend(fi.absoluteFilePath(),pFFOption);
         }
         else if(fi.isDir()&&((pFFOption->bSubdirectories)||(nLevel==0)))
         {
+#if defined(Q_OS_UNIX)&&defined(DT_DIR)
+            // readdir reports the entry type, so regular files and directories need no stat
+            DIR *pDir=opendir(QFile::encodeName(fi.absoluteFilePath()).constData());
+
+            if(pDir)
+            {
+                QString sPrefix=fi.absoluteFilePath();
+
+                if(!sPrefix.endsWith("/"))
+                {
+                    sPrefix+="/";
+                }
+
+                struct dirent *pEntry=nullptr;
+
+                while((!(*(pFFOption->pbIsStop)))&&(pEntry=readdir(pDir)))
+                {
+                    // ".", ".." and hidden files, which QDir skips by default
+                    if(pEntry->d_name[0]=='.')
+                    {
+                        continue;
+                    }
+
+                    QString sFileName=sPrefix+QFile::decodeName(pEntry->d_name);
+
+                    if(pEntry->d_type==DT_REG)
+                    {
+                        _findFilesAppend(sFileName,pFFOption);
+                    }
+                    else if((pEntry->d_type==DT_DIR)||(pEntry->d_type==DT_LNK)||(pEntry->d_type==DT_UNKNOWN))
+                    {
+                        findFiles(sFileName,pFFOption,nLevel+1);
+                    }
+                }
+
+                closedir(pDir);
+            }
+#else
             QDir dir(sDirectoryName);
 
             QFileInfoList eil=dir.entryInfoList();
@@ -175,10 +228,28 @@ void XBinary::findFiles(QString sDirectoryName, XBinary::FFOPTIONS *pFFOption, q
                     findFiles(eil.at(i).absoluteFilePath(),pFFOption,nLevel+1);
                 }
             }
+#endif
         }
     }
 }
 
+void XBinary::_findFilesAppend(QString sFileName, XBinary::FFOPTIONS *pFFOption)
+{
+    if(pFFOption->pFileCallback)
+    {
+        pFFOption->pFileCallback(sFileName,pFFOption->pUserData);
+    }
+    else
+    {
+        pFFOption->pListFiles->append(sFileName);
+    }
+
+    if(pFFOption->pnNumberOfFiles)
+    {
+        (*(pFFOption->pnNumberOfFiles))++;
+    }
+}
+
 QString XBinary::regExp(QString sRegExp, QString sString, int nIndex)
 {
     QString sResult;
@@ -214,14 +285,30 @@ qint64 XBinary::read_array(qint64 nOffset, char *pBuffer, qint64 nMaxSize)
 {
     qint64 nResult=0;
 
-    if(__pDevice->seek(nOffset))
+    if(__pMemory)
+    {
+        if((nOffset>=0)&&(nOffset<__nMemorySize))
+        {
+            if((nMaxSize==-1)||(nMaxSize>__nMemorySize-nOffset))
+            {
+                nMaxSize=__nMemorySize-nOffset;
+            }
+
+            if(nMaxSize>0)
+            {
+                memcpy(pBuffer,__pMemory+nOffset,nMaxSize);
+                nResult=nMaxSize;
+            }
+        }
+    }
+    else
     {
         if(nMaxSize==-1)
         {
             nMaxSize=getSize()-nOffset;
         }
 
-        nResult=__pDevice->read(pBuffer,nMaxSize);  // Check for read large files
+        nResult=SubDevice::readAt(__pDevice,nOffset,pBuffer,nMaxSize);  // Check for read large files
     }
 
     return nResult;
@@ -243,6 +330,44 @@ QByteArray XBinary::read_array(qint64 nOffset, qint64 nSize)
     return baResult;
 }
 
+XBinary::DATAVIEW XBinary::getDataView(qint64 nOffset, qint64 nSize)
+{
+    DATAVIEW result= {};
+
+    if(__pMemory)
+    {
+        if((nOffset>=0)&&(nOffset<__nMemorySize))
+        {
+            if((nSize==-1)||(nSize>__nMemorySize-nOffset))
+            {
+                nSize=__nMemorySize-nOffset;
+            }
+
+            if(nSize>0)
+            {
+                result.pData=__pMemory+nOffset;
+                result.nSize=nSize;
+            }
+        }
+    }
+    else
+    {
+        if(nSize==-1)
+        {
+            nSize=getSize()-nOffset;
+        }
+
+        if(nSize>0)
+        {
+            result.baPinned=read_array(nOffset,nSize);
+            result.pData=result.baPinned.constData();
+            result.nSize=result.baPinned.size();
+        }
+    }
+
+    return result;
+}
+
 qint64 XBinary::write_array(qint64 nOffset, char *pBuffer, qint64 nMaxSize)
 {
     qint64 nResult=0;
@@ -253,6 +378,8 @@ qint64 XBinary::write_array(qint64 nOffset, char *pBuffer, qint64 nMaxSize)
         {
             nResult=__pDevice->write(pBuffer,nMaxSize);
         }
+
+        _resetMemoryIndex();
     }
 
     return nResult;
@@ -395,7 +522,7 @@ QString XBinary::read_ansiString(qint64 nOffset,qint64 nMaxSize)
 
     if(nMaxSize)
     {
-        if(__pDevice->seek(nOffset))
+        if((nOffset>=0)&&(nOffset<getSize()))
         {
             // TODO optimize
             QByteArray baData=read_array(nOffset,nMaxSize);
@@ -821,9 +948,17 @@ qint64 XBinary::find_array(qint64 nOffset, qint64 nSize,const char *pArray, qint
         return -1;
     }
 
+    if(__pMemory&&(nOffset>=0))
+    {
+        qint64 nIndex=_findMemory(__pMemory+nOffset,nSize,pArray,nArraySize);
+
+        return (nIndex!=-1)?(nOffset+nIndex):(-1);
+    }
+
     qint64 nTemp=0;
-    const int BUFFER_SIZE=0x1000;
-    char *pBuffer=new char[BUFFER_SIZE+(nArraySize-1)];
+    const int BUFFER_SIZE=0x10000;
+    XArena::SCRATCH scratch(BUFFER_SIZE+(nArraySize-1));
+    char *pBuffer=scratch.data();
 
     while(nSize>nArraySize-1)
     {
@@ -834,22 +969,17 @@ qint64 XBinary::find_array(qint64 nOffset, qint64 nSize,const char *pArray, qint
             break;
         }
 
-        for(unsigned int i=0; i<nTemp-(nArraySize-1); i++)
-        {
-            if(compareMemory(pBuffer+i,pArray,nArraySize))
-            {
-                delete[] pBuffer;
+        qint64 nIndex=_findMemory(pBuffer,nTemp,pArray,nArraySize);
 
-                return nOffset+i;
-            }
+        if(nIndex!=-1)
+        {
+            return nOffset+nIndex;
         }
 
         nSize-=nTemp-(nArraySize-1);
         nOffset+=nTemp-(nArraySize-1);
     }
 
-    delete[] pBuffer;
-
     return -1;
 }
 
@@ -963,16 +1093,148 @@ qint64 XBinary::find_unicodeString(qint64 nOffset, qint64 nSize, QString sString
     return find_array(nOffset,nSize,(char *)sString.utf16(),sString.size()*2);
 }
 
+QList<qint64> XBinary::find_arrays(qint64 nOffset, qint64 nSize, const QList<QByteArray> *pListArrays)
+{
+    QList<qint64> listResult;
+
+    int nArraysCount=pListArrays->count();
+
+    for(int i=0; i<nArraysCount; i++)
+    {
+        listResult.append(-1);
+    }
+
+    qint64 _nSize=getSize();
+
+    if(nSize==-1)
+    {
+        nSize=_nSize-nOffset;
+    }
+
+    if(nSize<=0)
+    {
+        return listResult;
+    }
+
+    if(nOffset+nSize>_nSize)
+    {
+        return listResult;
+    }
+
+    // Arrays are grouped by the first byte: the bitmap skips the bytes no array starts with,
+    // the group of the byte b is listIndexes[nGroupStarts[b]..nGroupStarts[b+1])
+    quint32 nFirstBytes[8]= {};
+    int nGroupStarts[257]= {};
+    qint64 nMaxArraySize=1;
+    int nNotFound=0;
+
+    for(int i=0; i<nArraysCount; i++)
+    {
+        qint64 nArraySize=pListArrays->at(i).size();
+
+        if((nArraySize>0)&&(nArraySize<=nSize))
+        {
+            quint8 nByte=(quint8)pListArrays->at(i).at(0);
+
+            nFirstBytes[nByte>>5]|=(1u<<(nByte&31));
+            nGroupStarts[nByte+1]++;
+            nMaxArraySize=qMax(nMaxArraySize,nArraySize);
+            nNotFound++;
+        }
+    }
+
+    for(int i=0; i<256; i++)
+    {
+        nGroupStarts[i+1]+=nGroupStarts[i];
+    }
+
+    QVector<int> listIndexes(nNotFound);
+    int nGroupFill[256];
+    memcpy(nGroupFill,nGroupStarts,sizeof(nGroupFill));
+
+    for(int i=0; i<nArraysCount; i++)
+    {
+        qint64 nArraySize=pListArrays->at(i).size();
+
+        if((nArraySize>0)&&(nArraySize<=nSize))
+        {
+            listIndexes[nGroupFill[(quint8)pListArrays->at(i).at(0)]++]=i;
+        }
+    }
+
+    // In-memory data is swept in place as one buffer
+    bool bIsMemory=(__pMemory&&(nOffset>=0));
+
+    qint64 nTemp=0;
+    const int BUFFER_SIZE=0x10000;
+    XArena::SCRATCH scratch(bIsMemory?0:(BUFFER_SIZE+(nMaxArraySize-1)));
+    const char *pBuffer=nullptr;
+
+    while((nSize>0)&&(nNotFound))
+    {
+        if(bIsMemory)
+        {
+            nTemp=nSize;
+            pBuffer=__pMemory+nOffset;
+        }
+        else
+        {
+            nTemp=qMin((qint64)(BUFFER_SIZE+(nMaxArraySize-1)),nSize);
+
+            if(read_array(nOffset,scratch.data(),nTemp)!=nTemp)
+            {
+                break;
+            }
+
+            pBuffer=scratch.data();
+        }
+
+        // The tail is checked with the next buffer, except for the last one
+        qint64 nStep=(nTemp==nSize)?(nTemp):(nTemp-(nMaxArraySize-1));
+
+        for(qint64 i=0; (i<nStep)&&(nNotFound); i++)
+        {
+            quint8 nByte=(quint8)pBuffer[i];
+
+            if(!(nFirstBytes[nByte>>5]&(1u<<(nByte&31))))
+            {
+                continue;
+            }
+
+            int nGroupEnd=nGroupStarts[nByte+1];
+
+            for(int j=nGroupStarts[nByte]; j<nGroupEnd; j++)
+            {
+                int nIndex=listIndexes.at(j);
+
+                if(listResult.at(nIndex)==-1)
+                {
+                    const QByteArray *pArray=&(pListArrays->at(nIndex));
+
+                    if((i+pArray->size()<=nTemp)&&(memcmp(pBuffer+i,pArray->constData(),pArray->size())==0))
+                    {
+                        listResult[nIndex]=nOffset+i;
+                        nNotFound--;
+                    }
+                }
+            }
+        }
+
+        nSize-=nStep;
+        nOffset+=nStep;
+    }
+
+    return listResult;
+}
+
 qint64 XBinary::find_signature(qint64 nOffset, qint64 nSize, QString sSignature)
 {
     sSignature=convertSignature(sSignature);
 
     qint64 nResult=-1;
 
-    if(sSignature.contains(".")||sSignature.contains("$")||sSignature.contains("#"))
+    if(sSignature.contains("$")||sSignature.contains("#"))
     {
-        sSignature=convertSignature(sSignature);
-
         QList<SIGNATURE_RECORD> records=getSignatureRecords(sSignature);
 
         for(qint64 i=0; i<nSize; i++)
@@ -984,6 +1246,16 @@ qint64 XBinary::find_signature(qint64 nOffset, qint64 nSize, QString sSignature)
             }
         }
     }
+    else if(sSignature.contains("."))
+    {
+        QByteArray baData;
+        QByteArray baMask;
+
+        if(compileSignature(sSignature,&baData,&baMask))
+        {
+            nResult=find_maskedArray(nOffset,nSize,baData.constData(),baMask.constData(),baData.size());
+        }
+    }
     else
     {
         QByteArray baData=QByteArray::fromHex(QByteArray(sSignature.toLatin1().data()));
@@ -993,6 +1265,65 @@ qint64 XBinary::find_signature(qint64 nOffset, qint64 nSize, QString sSignature)
     return nResult;
 }
 
+qint64 XBinary::find_maskedArray(qint64 nOffset, qint64 nSize, const char *pArray, const char *pMask, qint64 nArraySize)
+{
+    qint64 _nSize=getSize();
+
+    if(nSize==-1)
+    {
+        nSize=_nSize-nOffset;
+    }
+
+    if((nSize<=0)||(nArraySize<=0))
+    {
+        return -1;
+    }
+
+    if(nOffset+nSize>_nSize)
+    {
+        return -1;
+    }
+
+    if(nArraySize>nSize)
+    {
+        return -1;
+    }
+
+    if(__pMemory&&(nOffset>=0))
+    {
+        qint64 nIndex=_findMaskedMemory(__pMemory+nOffset,nSize,pArray,pMask,nArraySize);
+
+        return (nIndex!=-1)?(nOffset+nIndex):(-1);
+    }
+
+    qint64 nTemp=0;
+    const int BUFFER_SIZE=0x10000;
+    XArena::SCRATCH scratch(BUFFER_SIZE+(nArraySize-1));
+    char *pBuffer=scratch.data();
+
+    while(nSize>nArraySize-1)
+    {
+        nTemp=qMin((qint64)(BUFFER_SIZE+(nArraySize-1)),nSize);
+
+        if(!read_array(nOffset,pBuffer,nTemp))
+        {
+            break;
+        }
+
+        qint64 nIndex=_findMaskedMemory(pBuffer,nTemp,pArray,pMask,nArraySize);
+
+        if(nIndex!=-1)
+        {
+            return nOffset+nIndex;
+        }
+
+        nSize-=nTemp-(nArraySize-1);
+        nOffset+=nTemp-(nArraySize-1);
+    }
+
+    return -1;
+}
+
 bool XBinary::createFile(QString sFileName, qint64 nFileSize)
 {
     bool bResult=false;
@@ -1184,9 +1515,123 @@ bool XBinary::zeroFill(qint64 nOffset, qint64 nSize)
         }
     }
 
+    _resetMemoryIndex();
+
     return true;
 }
 
+qint64 XBinary::_findMemory(const char *pData, qint64 nDataSize, const char *pArray, qint64 nArraySize)
+{
+    if((nArraySize<=0)||(nDataSize<nArraySize))
+    {
+        return -1;
+    }
+
+    qint64 nLast=nDataSize-nArraySize; // the last possible position
+    qint64 i=0;
+
+#ifdef XBINARY_SSE2
+    // Positions where the first and the last bytes are the same, 16 at once
+    const __m128i mFirst=_mm_set1_epi8(pArray[0]);
+    const __m128i mLast=_mm_set1_epi8(pArray[nArraySize-1]);
+
+    for(; i+15<=nLast; i+=16)
+    {
+        __m128i mBlockFirst=_mm_loadu_si128((const __m128i *)(pData+i));
+        __m128i mBlockLast=_mm_loadu_si128((const __m128i *)(pData+i+nArraySize-1));
+
+        quint32 nBits=(quint32)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(mBlockFirst,mFirst),_mm_cmpeq_epi8(mBlockLast,mLast)));
+
+        while(nBits)
+        {
+            int nBit=0;
+
+            while(!(nBits&(1u<<nBit)))
+            {
+                nBit++;
+            }
+
+            if(memcmp(pData+i+nBit,pArray,nArraySize)==0)
+            {
+                return i+nBit;
+            }
+
+            nBits&=nBits-1;
+        }
+    }
+#endif
+
+    while(i<=nLast)
+    {
+        const char *pFound=(const char *)memchr(pData+i,pArray[0],nLast-i+1);
+
+        if(!pFound)
+        {
+            break;
+        }
+
+        i=pFound-pData;
+
+        if(memcmp(pData+i,pArray,nArraySize)==0)
+        {
+            return i;
+        }
+
+        i++;
+    }
+
+    return -1;
+}
+
+qint64 XBinary::_findMaskedMemory(const char *pData, qint64 nDataSize, const char *pArray, const char *pMask, qint64 nArraySize)
+{
+    if((nArraySize<=0)||(nDataSize<nArraySize))
+    {
+        return -1;
+    }
+
+    qint64 nLast=nDataSize-nArraySize;
+
+    // A byte without wildcards is used to skip to the candidates
+    qint64 nAnchor=-1;
+
+    for(qint64 j=0; j<nArraySize; j++)
+    {
+        if((quint8)pMask[j]==0xFF)
+        {
+            nAnchor=j;
+
+            break;
+        }
+    }
+
+    qint64 i=0;
+
+    while(i<=nLast)
+    {
+        if(nAnchor!=-1)
+        {
+            const char *pFound=(const char *)memchr(pData+i+nAnchor,pArray[nAnchor],nLast-i+1);
+
+            if(!pFound)
+            {
+                break;
+            }
+
+            i=(pFound-pData)-nAnchor;
+        }
+
+        if(compareSignatureData(pData+i,nDataSize-i,pArray,pMask,nArraySize))
+        {
+            return i;
+        }
+
+        i++;
+    }
+
+    return -1;
+}
+
 bool XBinary::compareMemory(char *pMemory1,const char *pMemory2, qint64 nSize)
 {
     // TODO optimize
@@ -1232,30 +1677,79 @@ bool XBinary::compareMemory(char *pMemory1,const char *pMemory2, qint64 nSize)
 
 bool XBinary::isOffsetValid(qint64 nOffset)
 {
-    QList<MEMORY_MAP> list=getMemoryMapList();
+    const MEMORY_INDEX *pIndex=getMemoryIndex();
 
-    return isOffsetValid(&list,nOffset);
+    return (_getMemoryIndexRecords(&(pIndex->listOffsetBounds),&(pIndex->listOffsetRecords),nOffset)!=nullptr);
 }
 
 bool XBinary::isAddressValid(qint64 nAddress,ADDRESS_SEGMENT segment)
 {
-    QList<MEMORY_MAP> list=getMemoryMapList();
+    bool bResult=false;
+
+    const MEMORY_INDEX *pIndex=getMemoryIndex();
+    const QVector<qint32> *pRecords=_getMemoryIndexRecords(&(pIndex->listAddressBounds),&(pIndex->listAddressRecords),nAddress);
+
+    if(pRecords)
+    {
+        for(int i=0; i<pRecords->count(); i++)
+        {
+            if(pIndex->listMemoryMap.at(pRecords->at(i)).segment==segment)
+            {
+                bResult=true;
+                break;
+            }
+        }
+    }
 
-    return isAddressValid(&list,nAddress,segment);
+    return bResult;
 }
 
 qint64 XBinary::offsetToAddress(qint64 nOffset,ADDRESS_SEGMENT segment)
 {
-    QList<MEMORY_MAP> list=getMemoryMapList();
+    qint64 nResult=-1;
+
+    const MEMORY_INDEX *pIndex=getMemoryIndex();
+    const QVector<qint32> *pRecords=_getMemoryIndexRecords(&(pIndex->listOffsetBounds),&(pIndex->listOffsetRecords),nOffset);
+
+    if(pRecords)
+    {
+        for(int i=0; i<pRecords->count(); i++)
+        {
+            const MEMORY_MAP &record=pIndex->listMemoryMap.at(pRecords->at(i));
+
+            if((record.nAddress!=-1)&&(record.segment==segment))
+            {
+                nResult=(nOffset-record.nOffset)+record.nAddress;
+                break;
+            }
+        }
+    }
 
-    return offsetToAddress(&list,nOffset,segment);
+    return nResult;
 }
 
 qint64 XBinary::addressToOffset(qint64 nAddress,ADDRESS_SEGMENT segment)
 {
-    QList<MEMORY_MAP> list=getMemoryMapList();
+    qint64 nResult=-1;
+
+    const MEMORY_INDEX *pIndex=getMemoryIndex();
+    const QVector<qint32> *pRecords=_getMemoryIndexRecords(&(pIndex->listAddressBounds),&(pIndex->listAddressRecords),nAddress);
+
+    if(pRecords)
+    {
+        for(int i=0; i<pRecords->count(); i++)
+        {
+            const MEMORY_MAP &record=pIndex->listMemoryMap.at(pRecords->at(i));
+
+            if((record.nOffset!=-1)&&(record.segment==segment))
+            {
+                nResult=(nAddress-record.nAddress)+record.nOffset;
+                break;
+            }
+        }
+    }
 
-    return addressToOffset(&list,nAddress,segment);
+    return nResult;
 }
 
 bool XBinary::isOffsetValid(QList<XBinary::MEMORY_MAP> *pMemoryMap, qint64 nOffset)
@@ -1388,6 +1882,32 @@ QList<XBinary::MEMORY_MAP> XBinary::getMemoryMapList()
 
     return listMemoryMap;
 }
+
+XBinary::MEMORY_INDEX XBinary::createMemoryIndex(QList<XBinary::MEMORY_MAP> *pMemoryMap)
+{
+    MEMORY_INDEX result;
+
+    result.listMemoryMap=*pMemoryMap;
+
+    _createMemoryIndex(pMemoryMap,false,&(result.listOffsetBounds),&(result.listOffsetRecords));
+    _createMemoryIndex(pMemoryMap,true,&(result.listAddressBounds),&(result.listAddressRecords));
+
+    return result;
+}
+
+const XBinary::MEMORY_INDEX *XBinary::getMemoryIndex()
+{
+    if(!__bIsMemoryIndexValid)
+    {
+        QList<MEMORY_MAP> listMemoryMap=getMemoryMapList();
+
+        __memoryIndex=createMemoryIndex(&listMemoryMap);
+        __bIsMemoryIndexValid=true;
+    }
+
+    return &__memoryIndex;
+}
+
 qint64 XBinary::getBaseAddress()
 {
     return this->__nBaseAddress;
@@ -1396,6 +1916,8 @@ qint64 XBinary::getBaseAddress()
 void XBinary::setBaseAddress(qint64 nBaseAddress)
 {
     this->__nBaseAddress=nBaseAddress;
+
+    _resetMemoryIndex();
 }
 
 bool XBinary::isImage()
@@ -1406,6 +1928,8 @@ bool XBinary::isImage()
 void XBinary::setIsImage(bool value)
 {
     bIsImage=value;
+
+    _resetMemoryIndex();
 }
 
 bool XBinary::compareSignature(QString sSignature, qint64 nOffset)
@@ -1512,6 +2036,8 @@ qint64 XBinary::getImageAddress()
 void XBinary::setImageBase(qint64 nValue)
 {
     this->__nImageBase=nValue;
+
+    _resetMemoryIndex();
 }
 
 qint64 XBinary::_getBaseAddress()
@@ -1971,7 +2497,8 @@ QString XBinary::getMD5(qint64 nOffset,qint64 nSize)
         const int BUFFER_SIZE=0x1000;
 
         quint64 nTemp=0;
-        char *pBuffer=new char[BUFFER_SIZE];
+        XArena::SCRATCH scratch(BUFFER_SIZE);
+        char *pBuffer=scratch.data();
 
         QCryptographicHash crypto(QCryptographicHash::Md5);
 
@@ -1981,7 +2508,6 @@ QString XBinary::getMD5(qint64 nOffset,qint64 nSize)
 
             if(!read_array(nOffset,pBuffer,nTemp))
             {
-                delete[] pBuffer;
                 return "";
             }
 
@@ -1991,8 +2517,6 @@ QString XBinary::getMD5(qint64 nOffset,qint64 nSize)
             nOffset+=nTemp;
         }
 
-        delete[] pBuffer;
-
         sResult=crypto.result().toHex();
     }
 
@@ -2013,7 +2537,8 @@ QString XBinary::getSHA1(qint64 nOffset, qint64 nSize)
         const int BUFFER_SIZE=0x1000;
 
         quint64 nTemp=0;
-        char *pBuffer=new char[BUFFER_SIZE];
+        XArena::SCRATCH scratch(BUFFER_SIZE);
+        char *pBuffer=scratch.data();
 
         QCryptographicHash crypto(QCryptographicHash::Sha1);
 
@@ -2023,7 +2548,6 @@ QString XBinary::getSHA1(qint64 nOffset, qint64 nSize)
 
             if(!read_array(nOffset,pBuffer,nTemp))
             {
-                delete[] pBuffer;
                 return "";
             }
 
@@ -2033,8 +2557,6 @@ QString XBinary::getSHA1(qint64 nOffset, qint64 nSize)
             nOffset+=nTemp;
         }
 
-        delete[] pBuffer;
-
         sResult=crypto.result().toHex();
     }
 
@@ -2087,7 +2609,8 @@ double XBinary::getEntropy(qint64 nOffset, qint64 nSize)
         const int BUFFER_SIZE=0x1000;
 
         quint64 nTemp=0;
-        char *pBuffer=new char[BUFFER_SIZE];
+        XArena::SCRATCH scratch(BUFFER_SIZE);
+        char *pBuffer=scratch.data();
 
         while(nSize>0)
         {
@@ -2095,7 +2618,6 @@ double XBinary::getEntropy(qint64 nOffset, qint64 nSize)
 
             if(!read_array(nOffset,pBuffer,nTemp))
             {
-                delete[] pBuffer;
                 return 0;
             }
 
@@ -2108,8 +2630,6 @@ double XBinary::getEntropy(qint64 nOffset, qint64 nSize)
             nOffset+=nTemp;
         }
 
-        delete[] pBuffer;
-
         double dTemp;
 
         for(int j=0; j<256; j++)
@@ -2178,6 +2698,38 @@ QIODevice *XBinary::getDevice()
     return __pDevice;
 }
 
+const char *XBinary::getMemory()
+{
+    return __pMemory;
+}
+
+const char *XBinary::getDeviceMemory(QIODevice *pDevice)
+{
+    const char *pResult=nullptr;
+
+    if(pDevice&&(!(pDevice->openMode()&QIODevice::WriteOnly)))
+    {
+        QBuffer *pBuffer=qobject_cast<QBuffer *>(pDevice);
+        SubDevice *pSubDevice=dynamic_cast<SubDevice *>(pDevice);
+
+        if(pBuffer)
+        {
+            pResult=pBuffer->data().constData();
+        }
+        else if(pSubDevice)
+        {
+            pResult=getDeviceMemory(pSubDevice->getOrigDevice());
+
+            if(pResult)
+            {
+                pResult+=pSubDevice->getInitOffset();
+            }
+        }
+    }
+
+    return pResult;
+}
+
 bool XBinary::isValid()
 {
     return true;
@@ -2185,14 +2737,19 @@ bool XBinary::isValid()
 
 QString XBinary::getSignature(qint64 nOffset, qint64 nSize)
 {
-    QString sResult;
+    return QString(getSignatureData(nOffset,nSize).toHex().toUpper());
+}
+
+QByteArray XBinary::getSignatureData(qint64 nOffset, qint64 nSize)
+{
+    QByteArray baResult;
 
     if(nOffset!=-1)
     {
-        sResult=read_array(nOffset,nSize).toHex().toUpper();
+        baResult=read_array(nOffset,nSize);
     }
 
-    return sResult;
+    return baResult;
 }
 
 XBinary::OFFSETSIZE XBinary::convertOffsetAndSize(qint64 nOffset, qint64 nSize)
@@ -2254,6 +2811,77 @@ bool XBinary::compareSignatureStrings(QString sBaseSignature, QString sOptSignat
     return true;
 }
 
+bool XBinary::compileSignature(QString sSignature, QByteArray *pbaData, QByteArray *pbaMask)
+{
+    // Only plain byte signatures: '.' is a wildcard nibble, '$' and '#' are not supported
+    sSignature=convertSignature(sSignature);
+
+    if(sSignature.size()&1)
+    {
+        sSignature.append(QChar('.'));
+    }
+
+    int nSize=sSignature.size()/2;
+
+    pbaData->resize(nSize);
+    pbaMask->resize(nSize);
+
+    bool bResult=(nSize>0);
+
+    for(int i=0; (i<nSize)&&(bResult); i++)
+    {
+        quint8 nData=0;
+        quint8 nMask=0;
+
+        for(int j=0; j<2; j++)
+        {
+            char c=sSignature.at(i*2+j).toLatin1();
+
+            nData<<=4;
+            nMask<<=4;
+
+            if((c>='0')&&(c<='9'))
+            {
+                nData|=(c-'0');
+                nMask|=0xF;
+            }
+            else if((c>='a')&&(c<='f'))
+            {
+                nData|=(c-'a'+10);
+                nMask|=0xF;
+            }
+            else if(c!='.')
+            {
+                bResult=false;
+                break;
+            }
+        }
+
+        pbaData->data()[i]=(char)nData;
+        pbaMask->data()[i]=(char)nMask;
+    }
+
+    return bResult;
+}
+
+bool XBinary::compareSignatureData(const char *pData, qint64 nDataSize, const char *pSignatureData, const char *pSignatureMask, qint64 nSignatureSize)
+{
+    if((nSignatureSize<=0)||(nDataSize<nSignatureSize))
+    {
+        return false;
+    }
+
+    for(qint64 i=0; i<nSignatureSize; i++)
+    {
+        if((pData[i]^pSignatureData[i])&pSignatureMask[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void XBinary::_errorMessage(QString sMessage)
 {
 #ifdef QT_DEBUG
@@ -3016,3 +3644,63 @@ bool XBinary::_isOffsetValid(qint64 nOffset)
     
     return (nOffset<nFileSize);
 }
+
+void XBinary::_resetMemoryIndex()
+{
+    __bIsMemoryIndexValid=false;
+}
+
+void XBinary::_createMemoryIndex(QList<XBinary::MEMORY_MAP> *pMemoryMap, bool bAddress, QVector<qint64> *pListBounds, QVector<QVector<qint32> > *pListRecords)
+{
+    int nCount=pMemoryMap->count();
+
+    QVector<qint64> listStarts(nCount,-1);
+
+    for(int i=0; i<nCount; i++)
+    {
+        qint64 nStart=bAddress?pMemoryMap->at(i).nAddress:pMemoryMap->at(i).nOffset;
+
+        if((pMemoryMap->at(i).nSize>0)&&(nStart!=-1))
+        {
+            listStarts[i]=nStart;
+            pListBounds->append(nStart);
+            pListBounds->append(nStart+pMemoryMap->at(i).nSize);
+        }
+    }
+
+    std::sort(pListBounds->begin(),pListBounds->end());
+    pListBounds->erase(std::unique(pListBounds->begin(),pListBounds->end()),pListBounds->end());
+
+    // Records may overlap; keep them in list order so lookups return what a linear walk would
+    for(int j=0; j<pListBounds->count()-1; j++)
+    {
+        QVector<qint32> listRecords;
+        qint64 nValue=pListBounds->at(j);
+
+        for(int i=0; i<nCount; i++)
+        {
+            if((listStarts.at(i)!=-1)&&(listStarts.at(i)<=nValue)&&(nValue<listStarts.at(i)+pMemoryMap->at(i).nSize))
+            {
+                listRecords.append(i);
+            }
+        }
+
+        pListRecords->append(listRecords);
+    }
+}
+
+const QVector<qint32> *XBinary::_getMemoryIndexRecords(const QVector<qint64> *pListBounds, const QVector<QVector<qint32> > *pListRecords, qint64 nValue)
+{
+    const QVector<qint32> *pResult=nullptr;
+
+    QVector<qint64>::const_iterator iter=std::upper_bound(pListBounds->constBegin(),pListBounds->constEnd(),nValue);
+
+    int nIndex=(int)(iter-pListBounds->constBegin())-1;
+
+    if((nIndex>=0)&&(nIndex<pListRecords->count())&&(!pListRecords->at(nIndex).isEmpty()))
+    {
+        pResult=&(pListRecords->at(nIndex));
+    }
+
+    return pResult;
+}
@@ -28,6 +28,7 @@
 #include <QDir>
 #include <QtEndian>
 #include <QMap>
+#include <QVector>
 #include <QBuffer>
 #include <QSet>
 #include <QTemporaryFile>
@@ -52,6 +53,7 @@
 #include "xmach_def.h"
 
 #include "subdevice.h"
+#include "xarena.h"
 
 #define S_ALIGN_DOWN(x,align)     ((x)&~(align-1))
 #define S_ALIGN_UP(x,align)       (((x)&(align-1))?S_ALIGN_DOWN(x,align)+align:x)
@@ -73,6 +75,19 @@ public:
         qint64 nSize;
     };
 
+    struct DATAVIEW
+    {
+        const char *pData;
+        qint64 nSize;
+        QByteArray baPinned; // a copy if the device is not in memory
+    };
+
+    struct STRING_VIEW
+    {
+        const char *pData; // not null-terminated
+        qint32 nSize;
+    };
+
     enum ADDRESS_SEGMENT
     {
         ADDRESS_SEGMENT_UNKNOWN=-1,
@@ -92,6 +107,16 @@ public:
         bool bIsOvelay;
         qint32 nLoadSection;
     };
+
+    // Sorted bounds of the memory map; every interval keeps the records covering it in list order
+    struct MEMORY_INDEX
+    {
+        QList<MEMORY_MAP> listMemoryMap;
+        QVector<qint64> listOffsetBounds;
+        QVector<QVector<qint32> > listOffsetRecords;
+        QVector<qint64> listAddressBounds;
+        QVector<QVector<qint32> > listAddressRecords;
+    };
     enum FT
     {
         FT_UNKNOWN=0,
@@ -146,6 +171,8 @@ public:
         bool bSubdirectories;
         bool *pbIsStop;
         qint32 *pnNumberOfFiles;
+        void (*pFileCallback)(QString sFileName,void *pUserData); // If set, files are passed here as they are found instead of to pListFiles
+        void *pUserData;
     };
     static void findFiles(QString sDirectoryName,FFOPTIONS *pFFOption,qint32 nLevel=0);
 
@@ -153,6 +180,7 @@ public:
     static bool isRegExpPresent(QString sRegExp,QString sString);
     qint64 read_array(qint64 nOffset,char *pBuffer,qint64 nMaxSize);
     QByteArray read_array(qint64 nOffset,qint64 nSize);
+    DATAVIEW getDataView(qint64 nOffset,qint64 nSize); // valid while the device and the view are alive
     qint64 write_array(qint64 nOffset,char *pBuffer,qint64 nMaxSize);
 
     quint8 read_uint8(qint64 nOffset);
@@ -211,6 +239,8 @@ public:
     qint64 find_ansiString(qint64 nOffset,qint64 nSize,QString sString);
     qint64 find_unicodeString(qint64 nOffset,qint64 nSize,QString sString); // mb TODO endian
     qint64 find_signature(qint64 nOffset,qint64 nSize,QString sSignature);
+    QList<qint64> find_arrays(qint64 nOffset,qint64 nSize,const QList<QByteArray> *pListArrays); // one pass for all arrays
+    qint64 find_maskedArray(qint64 nOffset,qint64 nSize,const char *pArray,const char *pMask,qint64 nArraySize);
 
     static bool createFile(QString sFileName,qint64 nFileSize=0);
     static bool isFileExists(QString sFileName);
@@ -223,6 +253,8 @@ public:
     static bool copyDeviceMemory(QIODevice *pSourceDevice,qint64 nSourceOffset,QIODevice *pDestDevice,qint64 nDestOffset,qint64 nSize,quint32 nBufferSize=0x1000);
     bool copyMemory(qint64 nSourceOffset, qint64 nDestOffset,qint64 nSize,quint32 nBufferSize=1,bool bReverse=false);
     bool zeroFill(qint64 nOffset,qint64 nSize);
+    static qint64 _findMemory(const char *pData,qint64 nDataSize,const char *pArray,qint64 nArraySize);
+    static qint64 _findMaskedMemory(const char *pData,qint64 nDataSize,const char *pArray,const char *pMask,qint64 nArraySize);
     static bool compareMemory(char *pMemory1,const char *pMemory2,qint64 nSize);
 
     bool isOffsetValid(qint64 nOffset);
@@ -241,6 +273,8 @@ public:
     static MEMORY_MAP getAddressMemoryMap(QList<MEMORY_MAP> *pMemoryMap,qint64 nAddress,ADDRESS_SEGMENT segment=ADDRESS_SEGMENT_FLAT);
 
     virtual QList<MEMORY_MAP> getMemoryMapList();
+    static MEMORY_INDEX createMemoryIndex(QList<MEMORY_MAP> *pMemoryMap);
+    const MEMORY_INDEX *getMemoryIndex();
     virtual qint64 getBaseAddress();
     virtual void setBaseAddress(qint64 nBaseAddress);
     virtual qint64 getEntryPointOffset();
@@ -299,13 +333,18 @@ public:
     static quint32 getCRC32(QString sString);
 
     QIODevice *getDevice();
+    const char *getMemory(); // nullptr if the data is not in memory
+    static const char *getDeviceMemory(QIODevice *pDevice);
     virtual bool isValid();
 
     QString getSignature(qint64 nOffset,qint64 nSize);
+    QByteArray getSignatureData(qint64 nOffset,qint64 nSize);
 
     OFFSETSIZE convertOffsetAndSize(qint64 nOffset,qint64 nSize);
 
     static bool compareSignatureStrings(QString sBaseSignature, QString sOptSignature);
+    static bool compileSignature(QString sSignature,QByteArray *pbaData,QByteArray *pbaMask);
+    static bool compareSignatureData(const char *pData,qint64 nDataSize,const char *pSignatureData,const char *pSignatureMask,qint64 nSignatureSize);
     static QString stringToHex(QString sString);
     static QString hexToString(QString sHex);
 
@@ -364,6 +403,12 @@ private:
 
 protected:
     bool _isOffsetValid(qint64 nOffset);
+    void _resetMemoryIndex();
+
+private:
+    static void _findFilesAppend(QString sFileName,FFOPTIONS *pFFOption);
+    static void _createMemoryIndex(QList<MEMORY_MAP> *pMemoryMap,bool bAddress,QVector<qint64> *pListBounds,QVector<QVector<qint32> > *pListRecords);
+    static const QVector<qint32> *_getMemoryIndexRecords(const QVector<qint64> *pListBounds,const QVector<QVector<qint32> > *pListRecords,qint64 nValue);
 
 protected:
     void _errorMessage(QString sMessage);
@@ -379,6 +424,22 @@ private:
     qint64 __nBaseAddress;
     qint64 __nEntryPointOffset;
     qint64 __nImageBase;
+    const char *__pMemory;
+    qint64 __nMemorySize;
+    bool __bIsMemoryIndexValid;
+    MEMORY_INDEX __memoryIndex;
 };
 
+Q_DECLARE_TYPEINFO(XBinary::STRING_VIEW,Q_PRIMITIVE_TYPE);
+
+inline bool operator==(const XBinary::STRING_VIEW &view1,const XBinary::STRING_VIEW &view2)
+{
+    return (view1.nSize==view2.nSize)&&(memcmp(view1.pData,view2.pData,view1.nSize)==0);
+}
+
+inline uint qHash(const XBinary::STRING_VIEW &view,uint nSeed=0)
+{
+    return qHashBits(view.pData,view.nSize,nSeed);
+}
+
 #endif // XBINARY_H
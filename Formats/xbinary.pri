@@ -2,9 +2,13 @@ INCLUDEPATH += $$PWD
 DEPENDPATH += $$PWD
 
 HEADERS += \
+    $$PWD/cachedevice.h \
     $$PWD/subdevice.h \
+    $$PWD/xarena.h \
     $$PWD/xbinary.h
 
 SOURCES += \
+    $$PWD/cachedevice.cpp \
     $$PWD/subdevice.cpp \
+    $$PWD/xarena.cpp \
     $$PWD/xbinary.cpp
@@ -22,12 +22,57 @@
 
 XPE::XPE(QIODevice *__pDevice, bool bIsImage, qint64 nImageBase): XMSDOS(__pDevice,bIsImage,nImageBase)
 {
+    __pModel=nullptr;
+}
+
+XPE::MODEL XPE::getModel()
+{
+    MODEL result= {};
+
+    result.bIsValid=isValid();
+
+    if(result.bIsValid)
+    {
+        result.bIs64=is64();
+        result.fileHeader=getFileHeader();
+
+        if(result.bIs64)
+        {
+            result.optionalHeader64=getOptionalHeader64();
+        }
+        else
+        {
+            result.optionalHeader32=getOptionalHeader32();
+        }
+
+        for(quint32 i=0; i<16; i++)
+        {
+            result.listDataDirectories.append(getOptionalHeader_DataDirectory(i));
+        }
+
+        result.listSectionHeaders=getSectionHeaders();
+        result.listMemoryMap=getMemoryMapList();
+        result.nEntryPointOffset=getEntryPointOffset();
+    }
+
+    return result;
+}
+
+void XPE::setModel(const XPE::MODEL *pModel)
+{
+    // The model must be built from the same device and options; setters do not update it
+    this->__pModel=pModel;
 }
 
 bool XPE::isValid()
 {
     bool bResult=false;
 
+    if(__pModel)
+    {
+        return __pModel->bIsValid;
+    }
+
     quint16 magic=get_magic();
 
     if(magic==(quint16)XMSDOS_DEF::S_IMAGE_DOS_SIGNATURE)
@@ -50,6 +95,11 @@ bool XPE::isValid()
 
 bool XPE::is64()
 {
+    if(__pModel)
+    {
+        return __pModel->bIs64;
+    }
+
     quint16 nMachine=getFileHeader_Machine();
 
     return  (nMachine==XPE_DEF::S_IMAGE_FILE_MACHINE_AMD64)||
@@ -184,7 +234,14 @@ XPE_DEF::S_IMAGE_FILE_HEADER XPE::getFileHeader()
 {
     XPE_DEF::S_IMAGE_FILE_HEADER result= {};
 
-    read_array(getFileHeaderOffset(),(char *)&result,sizeof(XPE_DEF::S_IMAGE_FILE_HEADER));
+    if(__pModel)
+    {
+        result=__pModel->fileHeader;
+    }
+    else
+    {
+        read_array(getFileHeaderOffset(),(char *)&result,sizeof(XPE_DEF::S_IMAGE_FILE_HEADER));
+    }
 
     return result;
 }
@@ -196,11 +253,21 @@ void XPE::setFileHeader(XPE_DEF::S_IMAGE_FILE_HEADER *pFileHeader)
 
 quint16 XPE::getFileHeader_Machine()
 {
+    if(__pModel)
+    {
+        return __pModel->fileHeader.Machine;
+    }
+
     return read_uint16(getFileHeaderOffset()+offsetof(XPE_DEF::S_IMAGE_FILE_HEADER,Machine));
 }
 
 quint16 XPE::getFileHeader_NumberOfSections()
 {
+    if(__pModel)
+    {
+        return __pModel->fileHeader.NumberOfSections;
+    }
+
     return read_uint16(getFileHeaderOffset()+offsetof(XPE_DEF::S_IMAGE_FILE_HEADER,NumberOfSections));
 }
 
@@ -280,7 +347,14 @@ XPE_DEF::IMAGE_OPTIONAL_HEADER32 XPE::getOptionalHeader32()
 {
     XPE_DEF::IMAGE_OPTIONAL_HEADER32 result= {};
 
-    read_array(getOptionalHeaderOffset(),(char *)&result,sizeof(XPE_DEF::IMAGE_OPTIONAL_HEADER32));
+    if(__pModel)
+    {
+        result=__pModel->optionalHeader32;
+    }
+    else
+    {
+        read_array(getOptionalHeaderOffset(),(char *)&result,sizeof(XPE_DEF::IMAGE_OPTIONAL_HEADER32));
+    }
 
     return result;
 }
@@ -289,7 +363,14 @@ XPE_DEF::IMAGE_OPTIONAL_HEADER64 XPE::getOptionalHeader64()
 {
     XPE_DEF::IMAGE_OPTIONAL_HEADER64 result= {};
 
-    read_array(getOptionalHeaderOffset(),(char *)&result,sizeof(XPE_DEF::IMAGE_OPTIONAL_HEADER64));
+    if(__pModel)
+    {
+        result=__pModel->optionalHeader64;
+    }
+    else
+    {
+        read_array(getOptionalHeaderOffset(),(char *)&result,sizeof(XPE_DEF::IMAGE_OPTIONAL_HEADER64));
+    }
 
     return result;
 }
@@ -366,6 +447,11 @@ quint32 XPE::getOptionalHeader_SizeOfUninitializedData()
 
 quint32 XPE::getOptionalHeader_AddressOfEntryPoint()
 {
+    if(__pModel)
+    {
+        return __pModel->bIs64?__pModel->optionalHeader64.AddressOfEntryPoint:__pModel->optionalHeader32.AddressOfEntryPoint;
+    }
+
     return read_uint32(getOptionalHeaderOffset()+offsetof(XPE_DEF::IMAGE_OPTIONAL_HEADER32,AddressOfEntryPoint));
 }
 
@@ -383,7 +469,11 @@ quint64 XPE::getOptionalHeader_ImageBase()
 {
     quint64 nResult=0;
 
-    if(is64())
+    if(__pModel)
+    {
+        nResult=__pModel->bIs64?__pModel->optionalHeader64.ImageBase:__pModel->optionalHeader32.ImageBase;
+    }
+    else if(is64())
     {
         nResult=read_uint64(getOptionalHeaderOffset()+offsetof(XPE_DEF::IMAGE_OPTIONAL_HEADER64,ImageBase));
     }
@@ -397,11 +487,21 @@ quint64 XPE::getOptionalHeader_ImageBase()
 
 quint32 XPE::getOptionalHeader_SectionAlignment()
 {
+    if(__pModel)
+    {
+        return __pModel->bIs64?__pModel->optionalHeader64.SectionAlignment:__pModel->optionalHeader32.SectionAlignment;
+    }
+
     return read_uint32(getOptionalHeaderOffset()+offsetof(XPE_DEF::IMAGE_OPTIONAL_HEADER32,SectionAlignment));
 }
 
 quint32 XPE::getOptionalHeader_FileAlignment()
 {
+    if(__pModel)
+    {
+        return __pModel->bIs64?__pModel->optionalHeader64.FileAlignment:__pModel->optionalHeader32.FileAlignment;
+    }
+
     return read_uint32(getOptionalHeaderOffset()+offsetof(XPE_DEF::IMAGE_OPTIONAL_HEADER32,FileAlignment));
 }
 
@@ -447,6 +547,11 @@ quint32 XPE::getOptionalHeader_SizeOfImage()
 
 quint32 XPE::getOptionalHeader_SizeOfHeaders()
 {
+    if(__pModel)
+    {
+        return __pModel->bIs64?__pModel->optionalHeader64.SizeOfHeaders:__pModel->optionalHeader32.SizeOfHeaders;
+    }
+
     return read_uint32(getOptionalHeaderOffset()+offsetof(XPE_DEF::IMAGE_OPTIONAL_HEADER32,SizeOfHeaders));
 }
 
@@ -766,7 +871,14 @@ XPE_DEF::IMAGE_DATA_DIRECTORY XPE::getOptionalHeader_DataDirectory(quint32 nNumb
     XPE_DEF::IMAGE_DATA_DIRECTORY result= {};
 
     //    if(nNumber<getOptionalHeader_NumberOfRvaAndSizes()) // There are some protectors with false NumberOfRvaAndSizes
-    if(nNumber<16)
+    if(__pModel)
+    {
+        if(nNumber<(quint32)__pModel->listDataDirectories.count())
+        {
+            result=__pModel->listDataDirectories.at(nNumber);
+        }
+    }
+    else if(nNumber<16)
     {
         if(is64())
         {
@@ -946,7 +1058,11 @@ XPE_DEF::IMAGE_SECTION_HEADER XPE::getSectionHeader(quint32 nNumber)
     XPE_DEF::IMAGE_SECTION_HEADER result= {};
     quint32 nNumberOfSections=getFileHeader_NumberOfSections();
 
-    if(nNumber<nNumberOfSections)
+    if(__pModel&&(nNumber<(quint32)__pModel->listSectionHeaders.count()))
+    {
+        result=__pModel->listSectionHeaders.at(nNumber);
+    }
+    else if(nNumber<nNumberOfSections)
     {
         read_array(getSectionsTableOffset()+nNumber*sizeof(XPE_DEF::IMAGE_SECTION_HEADER),(char *)&result,sizeof(XPE_DEF::IMAGE_SECTION_HEADER));
     }
@@ -966,6 +1082,11 @@ void XPE::setSectionHeader(quint32 nNumber, XPE_DEF::IMAGE_SECTION_HEADER *pSect
 
 QList<XPE_DEF::IMAGE_SECTION_HEADER> XPE::getSectionHeaders()
 {
+    if(__pModel)
+    {
+        return __pModel->listSectionHeaders;
+    }
+
     QList<XPE_DEF::IMAGE_SECTION_HEADER> listResult;
 
     quint32 nNumberOfSections=getFileHeader_NumberOfSections();
@@ -1331,6 +1452,11 @@ bool XPE::isImportPresent()
 
 QList<XBinary::MEMORY_MAP> XPE::getMemoryMapList()
 {
+    if(__pModel)
+    {
+        return __pModel->listMemoryMap;
+    }
+
     QList<MEMORY_MAP> list;
 
     quint32 nNumberOfSections=qMin((int)getFileHeader_NumberOfSections(),100);
@@ -1484,6 +1610,11 @@ void XPE::setBaseAddress(qint64 nBaseAddress)
 
 qint64 XPE::getEntryPointOffset()
 {
+    if(__pModel)
+    {
+        return __pModel->nEntryPointOffset;
+    }
+
     return addressToOffset(_getBaseAddress()+getOptionalHeader_AddressOfEntryPoint());
 }
 
@@ -4034,19 +4165,48 @@ XPE::CLI_INFO XPE::getCliInfo(bool bFindHidden)
                                 result.nCLI_MetaData_StringsOffset=result.listCLI_MetaData_Stream_Offsets.at(i)+result.nCLI_MetaDataOffset;
                                 result.nCLI_MetaData_StringsSize=result.listCLI_MetaData_Stream_Sizes.at(i);
 
-                                QByteArray baStrings=read_array(result.nCLI_MetaData_StringsOffset,result.nCLI_MetaData_StringsSize);
+                                // The entries are views into the heap, so the heap has to live as long as the info:
+                                // in memory it is used in place, otherwise it is read into the arena of the scan
+                                const char *_pOffset=nullptr;
+                                int _nSize=0;
+
+                                XArena *pArena=XArena::getCurrent();
+
+                                if(pArena&&(!getMemory())&&(result.nCLI_MetaData_StringsOffset>=0))
+                                {
+                                    qint64 nStringsSize=qMin(result.nCLI_MetaData_StringsSize,getSize()-result.nCLI_MetaData_StringsOffset);
+
+                                    if(nStringsSize>0)
+                                    {
+                                        char *pStrings=pArena->allocate(nStringsSize);
+
+                                        _pOffset=pStrings;
+                                        _nSize=(int)read_array(result.nCLI_MetaData_StringsOffset,pStrings,nStringsSize);
+                                    }
+                                }
+                                else
+                                {
+                                    DATAVIEW dvStrings=getDataView(result.nCLI_MetaData_StringsOffset,result.nCLI_MetaData_StringsSize);
 
-                                char *_pOffset=baStrings.data();
-                                int _nSize=baStrings.size();
+                                    result.baAnsiStrings=dvStrings.baPinned; // Shares the data of the view
+                                    _pOffset=dvStrings.pData;
+                                    _nSize=(int)dvStrings.nSize;
+                                }
 
                                 for(int i=1; i<_nSize; i++)
                                 {
                                     _pOffset++;
-                                    QString sTemp=_pOffset;
-                                    result.listAnsiStrings.append(sTemp);
+                                    // The view is not null-terminated
+                                    int nStringSize=(int)qstrnlen(_pOffset,_nSize-i);
+
+                                    STRING_VIEW view= {};
+                                    view.pData=_pOffset;
+                                    view.nSize=nStringSize;
 
-                                    _pOffset+=sTemp.size();
-                                    i+=sTemp.size();
+                                    result.listAnsiStrings.append(view);
+
+                                    _pOffset+=nStringSize;
+                                    i+=nStringSize;
                                 }
                             }
                             else if(result.listCLI_MetaData_Stream_Names.at(i)=="#US")
@@ -4054,11 +4214,11 @@ XPE::CLI_INFO XPE::getCliInfo(bool bFindHidden)
                                 result.nCLI_MetaData_USOffset=result.listCLI_MetaData_Stream_Offsets.at(i)+result.nCLI_MetaDataOffset;
                                 result.nCLI_MetaData_USSize=result.listCLI_MetaData_Stream_Sizes.at(i);
 
-                                QByteArray baStrings=read_array(result.nCLI_MetaData_USOffset,result.nCLI_MetaData_USSize);
+                                DATAVIEW dvStrings=getDataView(result.nCLI_MetaData_USOffset,result.nCLI_MetaData_USSize);
 
-                                char *_pOffset=baStrings.data();
-                                char *__pOffset=_pOffset;
-                                int _nSize=baStrings.size();
+                                const char *_pOffset=dvStrings.pData;
+                                const char *__pOffset=_pOffset;
+                                int _nSize=(int)dvStrings.nSize;
 
                                 __pOffset++;
 
@@ -4303,13 +4463,19 @@ bool XPE::isNETAnsiStringPresent(QString sString, XPE::CLI_INFO *pCliInfo)
 {
     bool bResult=false;
 
+    QByteArray baString=sString.toUtf8();
+
+    STRING_VIEW viewString= {};
+    viewString.pData=baString.constData();
+    viewString.nSize=baString.size();
+
     for(int i=0; i<pCliInfo->listAnsiStrings.count(); i++)
     {
-        QString sRecord=pCliInfo->listAnsiStrings.at(i);
+        STRING_VIEW viewRecord=pCliInfo->listAnsiStrings.at(i);
 
-        if(sRecord!="")
+        if(viewRecord.nSize)
         {
-            if(sString==sRecord)
+            if(viewString==viewRecord)
             {
                 bResult=true;
                 break;
@@ -4885,7 +5051,8 @@ quint16 XPE::_checkSum(qint64 nStartValue,qint64 nDataSize)
     const int BUFFER_SIZE=0x1000;
     int nSum=(int)nStartValue;
     unsigned int nTemp=0;
-    char *pBuffer=new char[BUFFER_SIZE];
+    XArena::SCRATCH scratch(BUFFER_SIZE);
+    char *pBuffer=scratch.data();
     char *pOffset;
 
     while(nDataSize>0)
@@ -4894,8 +5061,6 @@ quint16 XPE::_checkSum(qint64 nStartValue,qint64 nDataSize)
 
         if(!read_array(nStartValue,pBuffer,nTemp))
         {
-            delete[] pBuffer;
-
             return false;
         }
 
@@ -4917,8 +5082,6 @@ quint16 XPE::_checkSum(qint64 nStartValue,qint64 nDataSize)
         nStartValue+=nTemp;
     }
 
-    delete[] pBuffer;
-
     return (unsigned short)(S_LOWORD(nSum)+S_HIWORD(nSum));
 }
 
@@ -234,7 +234,8 @@ public:
         qint64 nEntryPoint;
         qint64 nEntryPointSize;
 
-        QList<QString> listAnsiStrings;
+        QVector<STRING_VIEW> listAnsiStrings; // UTF-8, into the file data, the scan arena (XArena) or baAnsiStrings
+        QByteArray baAnsiStrings; // The #Strings heap if it is neither in memory nor in an arena
         QList<QString> listUnicodeStrings;
     };
 
@@ -253,7 +254,23 @@ public:
         QString sLibrary;
     };
 
+    // Headers parsed once; an XPE with a model set answers header queries without reading the device
+    struct MODEL
+    {
+        bool bIsValid;
+        bool bIs64;
+        XPE_DEF::S_IMAGE_FILE_HEADER fileHeader;
+        XPE_DEF::IMAGE_OPTIONAL_HEADER32 optionalHeader32;
+        XPE_DEF::IMAGE_OPTIONAL_HEADER64 optionalHeader64;
+        QList<XPE_DEF::IMAGE_DATA_DIRECTORY> listDataDirectories;
+        QList<XPE_DEF::IMAGE_SECTION_HEADER> listSectionHeaders;
+        QList<MEMORY_MAP> listMemoryMap;
+        qint64 nEntryPointOffset;
+    };
+
     explicit XPE(QIODevice *__pDevice=nullptr,bool bIsImage=false,qint64 nImageBase=-1);
+    MODEL getModel();
+    void setModel(const MODEL *pModel);
     virtual bool isValid();
     bool is64();
 
@@ -651,6 +668,8 @@ public:
     static QByteArray createHeaderStub(HEADER_OPTIONS *pHeaderOptions);
 
 private:
+    const MODEL *__pModel;
+
     quint16 _checkSum(qint64 nStartValue,qint64 nDataSize);
     qint64 _calculateRawSize();
     RESOURCE_POSITION _getResourcePosition(QList<MEMORY_MAP> *pMemoryMap, qint64 nBaseAddress, qint64 nResourceOffset, qint64 nOffset, quint32 nLevel);
@@ -2,3 +2,4 @@ TEMPLATE      = subdirs
 
 SUBDIRS        += gui_source
 SUBDIRS        += console_source
+SUBDIRS        += lib_source
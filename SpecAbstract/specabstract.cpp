@@ -21,7 +21,7 @@
 
 #include "specabstract.h"
 
-SpecAbstract::SIGNATURE_RECORD _binary_records[]=
+SPECABSTRACT_CONSTEXPR const SpecAbstract::SIGNATURE_RECORD _binary_records[]=
 {
     {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_INSTALLERDATA,    SpecAbstract::RECORD_NAME_INNOSETUP,                    "",             "Install",              "'idska32'1A"},
     {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_INSTALLERDATA,    SpecAbstract::RECORD_NAME_INNOSETUP,                    "",             "Install",              "'zlb'1A"}, // TODO none
@@ -58,7 +58,7 @@ SpecAbstract::SIGNATURE_RECORD _binary_records[]=
     {1, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_PROTECTORDATA,    SpecAbstract::RECORD_NAME_FISHNET,                      "1.X",          "",                     "000800'FISH_NET'0100"},
     {2, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_PROTECTORDATA,    SpecAbstract::RECORD_NAME_FISHNET,                      "1.X",          "",                     "00000800'FISH_NET'0100"},
     {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_INSTALLERDATA,    SpecAbstract::RECORD_NAME_SMARTINSTALLMAKER,            "",             "",                     "'Smart Install Maker v'"},
-    {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_INSTALLERDATA,    SpecAbstract::RECORD_NAME_TARMAINSTALLER,               "",             "zlib",                 "'tiz1'........78da'"},
+    {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_INSTALLERDATA,    SpecAbstract::RECORD_NAME_TARMAINSTALLER,               "",             "zlib",                 "'tiz1'........78da"},
     {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_INSTALLERDATA,    SpecAbstract::RECORD_NAME_CLICKTEAM,                    "",             "",                     "'wwgT)'"},
     {1, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_INSTALLERDATA,    SpecAbstract::RECORD_NAME_CLICKTEAM,                    "",             "",                     "..120100....0000"},
     {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_SFXDATA,          SpecAbstract::RECORD_NAME_WINRAR,                       "",             "",                     "'***messages***'"},
@@ -87,7 +87,7 @@ SpecAbstract::SIGNATURE_RECORD _binary_records[]=
     {0, SpecAbstract::RECORD_FILETYPE_BINARY,   SpecAbstract::RECORD_TYPE_IMAGE,            SpecAbstract::RECORD_NAME_DJVU,                         "",             "",                     "'AT&T'"},
 };
 
-SpecAbstract::SIGNATURE_RECORD _PE_header_records[]=
+SPECABSTRACT_CONSTEXPR const SpecAbstract::SIGNATURE_RECORD _PE_header_records[]=
 {
     {0, SpecAbstract::RECORD_FILETYPE_PE,       SpecAbstract::RECORD_TYPE_LINKER,           SpecAbstract::RECORD_NAME_TURBOLINKER,                  "",             "",                     "'MZ'50000200000004000F00FFFF0000B80000000000000040001A000000000000000000000000000000000000000000000000000000000000000000....0000BA10000E1FB409CD21B8014CCD219090'This program must be run under Win'....'\r\n$'370000000000"},
     {0, SpecAbstract::RECORD_FILETYPE_PE,       SpecAbstract::RECORD_TYPE_LINKER,           SpecAbstract::RECORD_NAME_TURBOLINKER,                  "",             "Patched",              "'MZ'............................................................................................................................BA10000E1FB409CD21B8014CCD219090'This program must be run under Win'....'\r\n$'370000000000"},
@@ -111,7 +111,7 @@ SpecAbstract::SIGNATURE_RECORD _PE_header_records[]=
     {0, SpecAbstract::RECORD_FILETYPE_PE64,     SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_MPRESS,                       "1.27-2.12",    "Win64/exe",            "'MZ'........................................................................................'Win64 .EXE.\r\n'"},
     {0, SpecAbstract::RECORD_FILETYPE_PE32,     SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_MPRESS,                       "1.27-2.12",    "Win32/dll",            "'MZ'........................................................................................'Win32 .DLL.\r\n'"},
     {0, SpecAbstract::RECORD_FILETYPE_PE64,     SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_MPRESS,                       "1.27-2.12",    "Win64/dll",            "'MZ'........................................................................................'Win64 .DLL.\r\n'"},
-    {0, SpecAbstract::RECORD_FILETYPE_PE,       SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_MPRESS,                       "1.27-2.12",    ".NET",                 "'MZ'........................................................................................'It'27's .NET EXE"},
+    {0, SpecAbstract::RECORD_FILETYPE_PE,       SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_MPRESS,                       "1.27-2.12",    ".NET",                 "'MZ'........................................................................................'It'27's .NET EXE'"},
     {0, SpecAbstract::RECORD_FILETYPE_PE32,     SpecAbstract::RECORD_TYPE_INSTALLER,        SpecAbstract::RECORD_NAME_INNOSETUP,                    "1.XX-5.1.X",   "Install",              "'MZ'............................................................................................496E6E6F"}, // TODO Versions
     {0, SpecAbstract::RECORD_FILETYPE_PE32,     SpecAbstract::RECORD_TYPE_INSTALLER,        SpecAbstract::RECORD_NAME_INNOSETUP,                    "",             "Uninstall",            "'MZ'............................................................................................496E556E"},
     {0, SpecAbstract::RECORD_FILETYPE_PE32,     SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_ANDPAKK2,                     "0.18",         "",                     "'MZ'00'ANDpakk2'00'PE'0000"},
@@ -142,7 +142,7 @@ SpecAbstract::SIGNATURE_RECORD _PE_header_records[]=
 
 };
 
-SpecAbstract::SIGNATURE_RECORD _PE_entrypoint_records[]=
+SPECABSTRACT_CONSTEXPR const SpecAbstract::SIGNATURE_RECORD _PE_entrypoint_records[]=
 {
     {0, SpecAbstract::RECORD_FILETYPE_PE32,     SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_UPX,                          "0.59",             "exe",                  "60E8000000005883E83D50"}, // mb TODO
     {0, SpecAbstract::RECORD_FILETYPE_PE32,     SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_UPX,                          "0.60-0.69",        "exe",                  "60E8........68........8BE88DBD........33DB033C248BF7"},
@@ -291,7 +291,7 @@ SpecAbstract::STRING_RECORD _TEXT_records[]=
     {0, SpecAbstract::RECORD_FILETYPE_TEXT,     SpecAbstract::RECORD_TYPE_SOURCECODE,       SpecAbstract::RECORD_NAME_PERL,                         "",             "",                     "#!/usr/bin/perl"},
 };
 
-SpecAbstract::SIGNATURE_RECORD _MSDOS_header_records[]=
+SPECABSTRACT_CONSTEXPR const SpecAbstract::SIGNATURE_RECORD _MSDOS_header_records[]=
 {
     {0, SpecAbstract::RECORD_FILETYPE_MSDOS,    SpecAbstract::RECORD_TYPE_PROTECTOR,        SpecAbstract::RECORD_NAME_CRYEXE,                       "4.0",          "",                     "'MZ'....................................................'CryEXE 4.0 By Iosco^DaTo!'"},
     {0, SpecAbstract::RECORD_FILETYPE_MSDOS,    SpecAbstract::RECORD_TYPE_PROTECTOR,        SpecAbstract::RECORD_NAME_LSCRYPRT,                     "1.21",         "",                     "'MZ'....................................................'L.S.    Crypt By'"},
@@ -301,7 +301,7 @@ SpecAbstract::SIGNATURE_RECORD _MSDOS_header_records[]=
     {0, SpecAbstract::RECORD_FILETYPE_MSDOS,    SpecAbstract::RECORD_TYPE_PACKER,           SpecAbstract::RECORD_NAME_WWPACK,                       "",             "",                     "'MZ'....................................................'WWP'"},
 };
 
-SpecAbstract::SIGNATURE_RECORD _MSDOS_entrypoint_records[]=
+SPECABSTRACT_CONSTEXPR const SpecAbstract::SIGNATURE_RECORD _MSDOS_entrypoint_records[]=
 {
     {0, SpecAbstract::RECORD_FILETYPE_MSDOS,    SpecAbstract::RECORD_TYPE_COMPILER,         SpecAbstract::RECORD_NAME_IBMPCPASCAL,                  "1.00(1981)",   "",                     "B8....8ED88C06....BA....D1EAB9....2BCAD1EA"},
     {0, SpecAbstract::RECORD_FILETYPE_MSDOS,    SpecAbstract::RECORD_TYPE_COMPILER,         SpecAbstract::RECORD_NAME_IBMPCPASCAL,                  "2.00(1984)",   "",                     "B8....8ED88C06....FA8ED0268B1E....2BD881FB....7E..BB....D1E3"},
@@ -313,21 +313,133 @@ SpecAbstract::SIGNATURE_RECORD _MSDOS_entrypoint_records[]=
     {0, SpecAbstract::RECORD_FILETYPE_MSDOS,    SpecAbstract::RECORD_TYPE_DOSEXTENDER,      SpecAbstract::RECORD_NAME_CAUSEWAY,                     "3.1X-3.4X",    "",                     "FA161F26A1....83E8..8ED0FB061607BE....8BFEB9....F3A407368C......8BD88CCA3603......368B......FD8BC53D....76"},
 };
 
+// Strings which are searched by the PE handlers, one pass per region finds all of them
+const char *_PE_codesection_probes[]=
+{
+    "\x07\x54\x4f\x62\x6a\x65\x63\x74", // TObject
+    "\x07\x42\x6f\x6f\x6c\x65\x61\x6e", // Boolean
+    "\x06\x73\x74\x72\x69\x6e\x67", // string
+    "\x06\x53\x74\x72\x69\x6e\x67", // String
+    "PowerBASIC",
+    "Setup version: Inno Setup version "
+};
+
+const char *_PE_datasection_probes[]=
+{
+    "Borland C++ - Copyright ",
+    "CodeGear C++ - Copyright ",
+    "Embarcadero RAD Studio - Copyright ",
+    "@(#) FLEXlm ",
+    "@(#) FLEXnet Licensing v",
+    "@(#) FlexNet Licensing v",
+    "FPC ",
+    "Lazarus LCL: ",
+    "\x0e\x52\x75\x6e\x74\x69\x6d\x65\x20\x65\x72\x72\x6f\x72\x20", // Runtime Error
+    "Virtual Pascal - Copyright (C) ",
+    "SOFTWARE\\InstallShield\\1"
+};
+
+const char *_PE_overlay_probes[]=
+{
+    "Inno Setup Messages (",
+    "Advanced Installer "
+};
+
 SpecAbstract::SpecAbstract(QObject *parent)
 {
     Q_UNUSED(parent);
 }
 
+namespace
+{
+struct _ID_COUNTER
+{
+    QAtomicInt nLastId; // The PE handler threads of a scan use the counter of the scan
+};
+
+struct _ID_CURRENT
+{
+    _ID_COUNTER *pCounter;
+    quint32 nLastId; // Outside of a scan
+
+    _ID_CURRENT() : pCounter(nullptr), nLastId(0)
+    {
+    }
+};
+
+// Values, not pointers: QThreadStorage would delete a pointer on thread exit
+QThreadStorage<_ID_CURRENT> g_idCurrent;
+
+// The outer scan of the thread numbers the IDs from 1, nested scans go on with the same counter.
+// A PE handler thread passes the counter of the scan it works for
+class _ID_SCOPE
+{
+public:
+    explicit _ID_SCOPE(_ID_COUNTER *pCounter=nullptr)
+    {
+        _ID_CURRENT *pCurrent=&(g_idCurrent.localData());
+
+        pPreviousCounter=pCurrent->pCounter;
+        pOwnCounter=nullptr;
+
+        if(pCounter)
+        {
+            pCurrent->pCounter=pCounter;
+        }
+        else if(!pCurrent->pCounter)
+        {
+            pOwnCounter=new _ID_COUNTER;
+            pCurrent->pCounter=pOwnCounter;
+        }
+    }
+
+    ~_ID_SCOPE()
+    {
+        g_idCurrent.localData().pCounter=pPreviousCounter;
+
+        delete pOwnCounter;
+    }
+
+    static _ID_COUNTER *getCurrent()
+    {
+        return g_idCurrent.localData().pCounter;
+    }
+
+private:
+    Q_DISABLE_COPY(_ID_SCOPE)
+
+    _ID_COUNTER *pPreviousCounter;
+    _ID_COUNTER *pOwnCounter;
+};
+}
+
 void SpecAbstract::scan(QIODevice *pDevice, SpecAbstract::SCAN_RESULT *pScanResult, qint64 nOffset, qint64 nSize, SpecAbstract::ID parentId, SpecAbstract::SCAN_OPTIONS *pOptions, bool bInit)
 {
     QElapsedTimer scanTimer;
     scanTimer.start();
 
+    // Transient buffers of the parsers come from one arena, released when the outer scan ends
+    XArenaScope arenaScope;
+    _ID_SCOPE idScope;
+
     if(QString(pDevice->metaObject()->className())=="QFile")
     {
         pScanResult->sFileName=((QFile *)pDevice)->fileName(); // TODO
     }
 
+    // Devices which are not in memory are read through a page cache; nested scans reuse the outer one
+    CacheDevice *pCacheDevice=nullptr;
+
+    if((!XBinary::getDeviceMemory(pDevice))&&(!CacheDevice::isCacheDevice(pDevice)))
+    {
+        pCacheDevice=new CacheDevice(pDevice);
+
+        if(pCacheDevice->open(QIODevice::ReadOnly))
+        {
+            pDevice=pCacheDevice;
+        }
+    }
+
     SubDevice sd(pDevice,nOffset,nSize);
 
     if(sd.open(QIODevice::ReadOnly))
@@ -368,6 +480,17 @@ void SpecAbstract::scan(QIODevice *pDevice, SpecAbstract::SCAN_RESULT *pScanResu
         sd.close();
     }
 
+    if(pCacheDevice)
+    {
+        CacheDevice::STATS cacheStats=pCacheDevice->getStats();
+
+        pScanResult->nCacheHits+=cacheStats.nHits;
+        pScanResult->nCacheMisses+=cacheStats.nMisses;
+
+        pCacheDevice->close();
+        delete pCacheDevice;
+    }
+
     if(bInit)
     {
         pScanResult->nScanTime=scanTimer.elapsed();
@@ -815,6 +938,25 @@ QString SpecAbstract::createFullResultString2(const SpecAbstract::SCAN_STRUCT *p
     return QString("%1: %2").arg(createTypeString(pScanStruct)).arg(createResultString2(pScanStruct));
 }
 
+QJsonObject SpecAbstract::createJsonObject(const SpecAbstract::SCAN_STRUCT *pScanStruct)
+{
+    QJsonObject result;
+
+    result.insert("id",(int)pScanStruct->id.nId);
+    result.insert("parentid",(int)pScanStruct->parentId.nId);
+    result.insert("filetype",recordFiletypeIdToString(pScanStruct->id.filetype));
+    result.insert("filepart",recordFilepartIdToString(pScanStruct->id.filepart));
+    result.insert("offset",(double)pScanStruct->nOffset);
+    result.insert("size",(double)pScanStruct->nSize);
+    result.insert("type",recordTypeIdToString(pScanStruct->type));
+    result.insert("name",recordNameIdToString(pScanStruct->name));
+    result.insert("version",pScanStruct->sVersion);
+    result.insert("info",pScanStruct->sInfo);
+    result.insert("string",createResultString2(pScanStruct));
+
+    return result;
+}
+
 QString SpecAbstract::createTypeString(const SpecAbstract::SCAN_STRUCT *pScanStruct)
 {
     QString sResult;
@@ -839,7 +981,6 @@ QString SpecAbstract::createTypeString(const SpecAbstract::SCAN_STRUCT *pScanStr
 SpecAbstract::SCAN_STRUCT SpecAbstract::createHeaderScanStruct(const SpecAbstract::SCAN_STRUCT *pScanStruct)
 {
     SCAN_STRUCT result=*pScanStruct;
-    result.id.uuid=QUuid::createUuid();
     result.type=RECORD_TYPE_GENERIC;
     result.name=RECORD_NAME_GENERIC;
     result.sVersion="";
@@ -848,6 +989,18 @@ SpecAbstract::SCAN_STRUCT SpecAbstract::createHeaderScanStruct(const SpecAbstrac
     return result;
 }
 
+quint32 SpecAbstract::createId()
+{
+    _ID_CURRENT *pCurrent=&(g_idCurrent.localData());
+
+    if(pCurrent->pCounter)
+    {
+        return (quint32)pCurrent->pCounter->nLastId.fetchAndAddOrdered(1)+1;
+    }
+
+    return ++(pCurrent->nLastId);
+}
+
 // TODO VI
 QString SpecAbstract::findEnigmaVersion(QIODevice *pDevice,bool bIsImage, qint64 nOffset, qint64 nSize)
 {
@@ -886,14 +1039,15 @@ SpecAbstract::BINARYINFO_STRUCT SpecAbstract::getBinaryInfo(QIODevice *pDevice,
     result.basic_info.parentId=parentId;
     result.basic_info.id.filetype=RECORD_FILETYPE_BINARY;
     result.basic_info.id.filepart=RECORD_FILEPART_HEADER;
-    result.basic_info.id.uuid=QUuid::createUuid();
+    result.basic_info.id.nId=createId();
     result.basic_info.nOffset=nOffset;
     result.basic_info.nSize=pDevice->size();
-    result.basic_info.sHeaderSignature=binary.getSignature(0,150);
+    result.basic_info.baHeader=binary.getSignatureData(0,150);
+    result.basic_info.sHeaderSignature=result.basic_info.baHeader.toHex().toUpper();
     result.basic_info.bIsDeepScan=pOptions->bDeepScan;
 
     // Scan Header
-    signatureScan(&result.basic_info.mapHeaderDetects,result.basic_info.sHeaderSignature,_binary_records,sizeof(_binary_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_BINARY);
+    signatureScan(&result.basic_info.mapHeaderDetects,&result.basic_info.baHeader,_binary_records,sizeof(_binary_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_BINARY);
 
     result.bIsPlainText=binary.isPlainTextType();
     result.bIsUTF8=binary.isUTF8TextType();
@@ -983,10 +1137,11 @@ SpecAbstract::MSDOSINFO_STRUCT SpecAbstract::getMSDOSInfo(QIODevice *pDevice, Sp
     result.basic_info.parentId=parentId;
     result.basic_info.id.filetype=RECORD_FILETYPE_MSDOS;
     result.basic_info.id.filepart=RECORD_FILEPART_HEADER;
-    result.basic_info.id.uuid=QUuid::createUuid();
+    result.basic_info.id.nId=createId();
     result.basic_info.nOffset=nOffset;
     result.basic_info.nSize=pDevice->size();
-    result.basic_info.sHeaderSignature=msdos.getSignature(0,150);
+    result.basic_info.baHeader=msdos.getSignatureData(0,150);
+    result.basic_info.sHeaderSignature=result.basic_info.baHeader.toHex().toUpper();
     result.basic_info.bIsDeepScan=pOptions->bDeepScan;
 
     result.nOverlayOffset=msdos.getOverlayOffset();
@@ -994,13 +1149,15 @@ SpecAbstract::MSDOSINFO_STRUCT SpecAbstract::getMSDOSInfo(QIODevice *pDevice, Sp
 
     if(result.nOverlaySize)
     {
-        result.sOverlaySignature=msdos.getSignature(result.nOverlayOffset,150);
+        result.baOverlay=msdos.getSignatureData(result.nOverlayOffset,150);
+        result.sOverlaySignature=result.baOverlay.toHex().toUpper();
     }
 
-    result.sEntryPointSignature=msdos.getSignature(msdos.getEntryPointOffset(),150);
+    result.baEntryPoint=msdos.getSignatureData(msdos.getEntryPointOffset(),150);
+    result.sEntryPointSignature=result.baEntryPoint.toHex().toUpper();
 
-    signatureScan(&result.basic_info.mapHeaderDetects,result.basic_info.sHeaderSignature,_MSDOS_header_records,sizeof(_MSDOS_header_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_MSDOS);
-    signatureScan(&result.mapEntryPointDetects,result.sEntryPointSignature,_MSDOS_entrypoint_records,sizeof(_MSDOS_entrypoint_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_MSDOS);
+    signatureScan(&result.basic_info.mapHeaderDetects,&result.basic_info.baHeader,_MSDOS_header_records,sizeof(_MSDOS_header_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_MSDOS);
+    signatureScan(&result.mapEntryPointDetects,&result.baEntryPoint,_MSDOS_entrypoint_records,sizeof(_MSDOS_entrypoint_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_MSDOS);
 
     MSDOS_handle_Borland(pDevice,pOptions->bIsImage,&result);
     MSDOS_handle_Tools(pDevice,pOptions->bIsImage,&result);
@@ -1051,7 +1208,7 @@ SpecAbstract::ELFINFO_STRUCT SpecAbstract::getELFInfo(QIODevice *pDevice, SpecAb
         result.basic_info.parentId=parentId;
         result.basic_info.id.filetype=result.bIs64?RECORD_FILETYPE_ELF64:RECORD_FILETYPE_ELF32;
         result.basic_info.id.filepart=RECORD_FILEPART_HEADER;
-        result.basic_info.id.uuid=QUuid::createUuid();
+        result.basic_info.id.nId=createId();
         result.basic_info.nOffset=nOffset;
         result.basic_info.nSize=pDevice->size();
         result.basic_info.sHeaderSignature=elf.getSignature(0,150);
@@ -1121,7 +1278,7 @@ SpecAbstract::MACHINFO_STRUCT SpecAbstract::getMACHInfo(QIODevice *pDevice, Spec
         result.basic_info.parentId=parentId;
         result.basic_info.id.filetype=result.bIs64?RECORD_FILETYPE_MACH64:RECORD_FILETYPE_MACH32;
         result.basic_info.id.filepart=RECORD_FILEPART_HEADER;
-        result.basic_info.id.uuid=QUuid::createUuid();
+        result.basic_info.id.nId=createId();
         result.basic_info.nOffset=nOffset;
         result.basic_info.nSize=pDevice->size();
         result.basic_info.sHeaderSignature=mach.getSignature(0,150);
@@ -1172,6 +1329,10 @@ SpecAbstract::PEINFO_STRUCT SpecAbstract::getPEInfo(QIODevice *pDevice, SpecAbst
 
     XPE pe(pDevice,pOptions->bIsImage);
 
+    // Headers, sections and the memory map are read here once and shared with the handlers
+    result.peModel=pe.getModel();
+    pe.setModel(&result.peModel);
+
     if(pe.isValid())
     {
         result.bIs64=pe.is64();
@@ -1179,13 +1340,15 @@ SpecAbstract::PEINFO_STRUCT SpecAbstract::getPEInfo(QIODevice *pDevice, SpecAbst
         result.basic_info.parentId=parentId;
         result.basic_info.id.filetype=result.bIs64?RECORD_FILETYPE_PE64:RECORD_FILETYPE_PE32;
         result.basic_info.id.filepart=RECORD_FILEPART_HEADER;
-        result.basic_info.id.uuid=QUuid::createUuid();
+        result.basic_info.id.nId=createId();
         result.basic_info.nOffset=nOffset;
         result.basic_info.nSize=pDevice->size();
-        result.basic_info.sHeaderSignature=pe.getSignature(0,150);
+        result.basic_info.baHeader=pe.getSignatureData(0,150);
+        result.basic_info.sHeaderSignature=result.basic_info.baHeader.toHex().toUpper();
         result.basic_info.bIsDeepScan=pOptions->bDeepScan;
 
-        result.sEntryPointSignature=pe.getSignature(pe.getEntryPointOffset(),150);
+        result.baEntryPoint=pe.getSignatureData(pe.getEntryPointOffset(),150);
+        result.sEntryPointSignature=result.baEntryPoint.toHex().toUpper();
 
         result.dosHeader=pe.getDosHeaderEx();
         result.fileHeader=pe.getFileHeader();
@@ -1194,7 +1357,8 @@ SpecAbstract::PEINFO_STRUCT SpecAbstract::getPEInfo(QIODevice *pDevice, SpecAbst
 
         if(result.nOverlaySize)
         {
-            result.sOverlaySignature=pe.getSignature(result.nOverlayOffset,150);
+            result.baOverlay=pe.getSignatureData(result.nOverlayOffset,150);
+            result.sOverlaySignature=result.baOverlay.toHex().toUpper();
         }
 
         if(result.bIs64)
@@ -1284,6 +1448,10 @@ SpecAbstract::PEINFO_STRUCT SpecAbstract::getPEInfo(QIODevice *pDevice, SpecAbst
             result.osImportSection.nSize=result.listSectionRecords.at(result.nImportSection).nSize;
         }
 
+        result.probeCodeSection=createRegionProbe(result.osCodeSection.nOffset,result.osCodeSection.nSize,_PE_codesection_probes,sizeof(_PE_codesection_probes));
+        result.probeDataSection=createRegionProbe(result.osDataSection.nOffset,result.osDataSection.nSize,_PE_datasection_probes,sizeof(_PE_datasection_probes));
+        result.probeOverlay=createRegionProbe(result.nOverlayOffset,result.nOverlaySize,_PE_overlay_probes,sizeof(_PE_overlay_probes));
+
         //        if(result.nCodeSectionSize)
         //        {
         //            memoryScan(&result.mapCodeSectionScanDetects,pDevice,result.nCodeSectionOffset,result.nCodeSectionSize,_codesectionscan_records,sizeof(_codesectionscan_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_PE);
@@ -1298,9 +1466,9 @@ SpecAbstract::PEINFO_STRUCT SpecAbstract::getPEInfo(QIODevice *pDevice, SpecAbst
 
         //        memoryScan(&result.mapHeaderScanDetects,pDevice,0,qMin(result.basic_info.nSize,(qint64)1024),_headerscan_records,sizeof(_headerscan_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_PE);
 
-        signatureScan(&result.basic_info.mapHeaderDetects,result.basic_info.sHeaderSignature,_PE_header_records,sizeof(_PE_header_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_PE);
-        signatureScan(&result.mapEntryPointDetects,result.sEntryPointSignature,_PE_entrypoint_records,sizeof(_PE_entrypoint_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_PE);
-        signatureScan(&result.mapOverlayDetects,result.sOverlaySignature,_binary_records,sizeof(_binary_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_BINARY);
+        signatureScan(&result.basic_info.mapHeaderDetects,&result.basic_info.baHeader,_PE_header_records,sizeof(_PE_header_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_PE);
+        signatureScan(&result.mapEntryPointDetects,&result.baEntryPoint,_PE_entrypoint_records,sizeof(_PE_entrypoint_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_PE);
+        signatureScan(&result.mapOverlayDetects,&result.baOverlay,_binary_records,sizeof(_binary_records),result.basic_info.id.filetype,SpecAbstract::RECORD_FILETYPE_BINARY);
 
         //        for(int i=0;i<result.listImports.count();i++)
         //        {
@@ -1325,28 +1493,7 @@ SpecAbstract::PEINFO_STRUCT SpecAbstract::getPEInfo(QIODevice *pDevice, SpecAbst
             //            }
         }
 
-        PE_handle_import(pDevice,pOptions->bIsImage,&result);
-
-        PE_handle_Protection(pDevice,pOptions->bIsImage,&result);
-        PE_handle_VMProtect(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Armadillo(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Obsidium(pDevice,pOptions->bIsImage,&result);
-        PE_handle_StarForce(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Petite(pDevice,pOptions->bIsImage,&result);
-        PE_handle_NETProtection(pDevice,pOptions->bIsImage,&result);
-        PE_handle_PolyMorph(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Microsoft(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Borland(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Watcom(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Tools(pDevice,pOptions->bIsImage,&result);
-        PE_handle_GCC(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Signtools(pDevice,pOptions->bIsImage,&result);
-        PE_handle_SFX(pDevice,pOptions->bIsImage,&result);
-        PE_handle_Installers(pDevice,pOptions->bIsImage,&result);
-        PE_handle_DongleProtection(pDevice,pOptions->bIsImage,&result);
-        PE_handle_UnknownProtection(pDevice,pOptions->bIsImage,&result);
-
-        PE_handle_FixDetects(pDevice,pOptions->bIsImage,&result);
+        PE_runHandlers(pDevice,pOptions->bIsImage,&result,pOptions->bParallelDetects);
 
         PE_handle_Recursive(pDevice,pOptions->bIsImage,&result,pOptions);
 
@@ -1398,6 +1545,11 @@ SpecAbstract::_SCANS_STRUCT SpecAbstract::getScansStruct(quint32 nVariant, SpecA
     return result;
 }
 
+SpecAbstract::_SCANS_STRUCT SpecAbstract::getScansStruct(quint32 nVariant, SpecAbstract::RECORD_FILETYPE filetype, SpecAbstract::RECORD_TYPE type, SpecAbstract::RECORD_NAME name, const char *pszVersion, const char *pszInfo, qint64 nOffset)
+{
+    return getScansStruct(nVariant,filetype,type,name,getPoolString(pszVersion),getPoolString(pszInfo),nOffset);
+}
+
 void SpecAbstract::PE_handle_import(QIODevice *pDevice, bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     Q_UNUSED(pDevice);
@@ -2538,6 +2690,7 @@ void SpecAbstract::PE_handle_import(QIODevice *pDevice, bool bIsImage, SpecAbstr
 void SpecAbstract::PE_handle_Protection(QIODevice *pDevice, bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -3560,6 +3713,7 @@ void SpecAbstract::PE_handle_Protection(QIODevice *pDevice, bool bIsImage, SpecA
 void SpecAbstract::PE_handle_VMProtect(QIODevice *pDevice,bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -3667,6 +3821,7 @@ void SpecAbstract::PE_handle_VMProtect(QIODevice *pDevice,bool bIsImage, SpecAbs
 void SpecAbstract::PE_handle_Armadillo(QIODevice *pDevice,bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -3690,6 +3845,7 @@ void SpecAbstract::PE_handle_Armadillo(QIODevice *pDevice,bool bIsImage, SpecAbs
 void SpecAbstract::PE_handle_Obsidium(QIODevice *pDevice, bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -3704,6 +3860,7 @@ void SpecAbstract::PE_handle_Obsidium(QIODevice *pDevice, bool bIsImage, SpecAbs
 void SpecAbstract::PE_handle_StarForce(QIODevice *pDevice, bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -3749,6 +3906,7 @@ void SpecAbstract::PE_handle_StarForce(QIODevice *pDevice, bool bIsImage, SpecAb
 void SpecAbstract::PE_handle_Petite(QIODevice *pDevice,bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -3872,6 +4030,7 @@ void SpecAbstract::PE_handle_Petite(QIODevice *pDevice,bool bIsImage, SpecAbstra
 void SpecAbstract::PE_handle_NETProtection(QIODevice *pDevice,bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -4095,6 +4254,7 @@ void SpecAbstract::PE_handle_Microsoft(QIODevice *pDevice,bool bIsImage, SpecAbs
     SpecAbstract::_SCANS_STRUCT recordNET= {};
 
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -4703,6 +4863,7 @@ void SpecAbstract::PE_handle_Borland(QIODevice *pDevice,bool bIsImage, SpecAbstr
 {
     // TODO Turbo Linker
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -4737,21 +4898,21 @@ void SpecAbstract::PE_handle_Borland(QIODevice *pDevice,bool bIsImage, SpecAbstr
                 qint64 _nOffset=pPEInfo->osCodeSection.nOffset;
                 qint64 _nSize=pPEInfo->osCodeSection.nSize;
 
-                nOffset_TObject=pe.find_array(_nOffset,_nSize,"\x07\x54\x4f\x62\x6a\x65\x63\x74",8); // TObject
+                nOffset_TObject=findRegionProbe(&pe,&(pPEInfo->probeCodeSection),"\x07\x54\x4f\x62\x6a\x65\x63\x74"); // TObject
 
                 if(nOffset_TObject!=-1)
                 {
-                    nOffset_Boolean=pe.find_array(_nOffset,_nSize,"\x07\x42\x6f\x6f\x6c\x65\x61\x6e",8); // Boolean
-                    nOffset_string=pe.find_array(_nOffset,_nSize,"\x06\x73\x74\x72\x69\x6e\x67",7); // string
+                    nOffset_Boolean=findRegionProbe(&pe,&(pPEInfo->probeCodeSection),"\x07\x42\x6f\x6f\x6c\x65\x61\x6e"); // Boolean
+                    nOffset_string=findRegionProbe(&pe,&(pPEInfo->probeCodeSection),"\x06\x73\x74\x72\x69\x6e\x67"); // string
 
                     if((nOffset_Boolean!=-1)||(nOffset_string!=-1))
                     {
                         if(nOffset_string==-1)
                         {
-                            nOffset_String=pe.find_array(_nOffset,_nSize,"\x06\x53\x74\x72\x69\x6e\x67",7); // String
+                            nOffset_String=findRegionProbe(&pe,&(pPEInfo->probeCodeSection),"\x06\x53\x74\x72\x69\x6e\x67"); // String
                         }
 
-                        listVCL=PE_getVCLstruct(pDevice,bIsImage,_nOffset,_nSize,pPEInfo->bIs64);
+                        listVCL=PE_getVCLstruct(pDevice,bIsImage,&pPEInfo->peModel,_nOffset,_nSize,pPEInfo->bIs64);
                     }
                 }
                 //            nOffset_AnsiString=pe.find_array(_nOffset,_nSize,"\x0a\x41\x6e\x73\x69\x53\x74\x72\x69\x6e\x67",11); // AnsiString
@@ -4760,18 +4921,15 @@ void SpecAbstract::PE_handle_Borland(QIODevice *pDevice,bool bIsImage, SpecAbstr
 
             if(XBinary::checkOffsetSize(pPEInfo->osDataSection)&&(pPEInfo->basic_info.bIsDeepScan))
             {
-                qint64 _nOffset=pPEInfo->osDataSection.nOffset;
-                qint64 _nSize=pPEInfo->osDataSection.nSize;
-
-                nOffset_BorlandCPP=pe.find_array(_nOffset,_nSize,"\x42\x6f\x72\x6c\x61\x6e\x64\x20\x43\x2b\x2b\x20\x2d\x20\x43\x6f\x70\x79\x72\x69\x67\x68\x74\x20",24); // Borland C++ - Copyright 1994 Borland Intl.
+                nOffset_BorlandCPP=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"Borland C++ - Copyright "); // Borland C++ - Copyright 1994 Borland Intl.
 
                 if(nOffset_BorlandCPP==-1)
                 {
-                    nOffset_CodegearCPP=pe.find_array(_nOffset,_nSize,"\x43\x6f\x64\x65\x47\x65\x61\x72\x20\x43\x2b\x2b\x20\x2d\x20\x43\x6f\x70\x79\x72\x69\x67\x68\x74\x20",25); // CodeGear C++ - Copyright 2008 Embarcadero Technologies
+                    nOffset_CodegearCPP=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"CodeGear C++ - Copyright "); // CodeGear C++ - Copyright 2008 Embarcadero Technologies
 
                     if(nOffset_CodegearCPP==-1)
                     {
-                        nOffset_EmbarcaderoCPP=pe.find_array(_nOffset,_nSize,"\x45\x6d\x62\x61\x72\x63\x61\x64\x65\x72\x6f\x20\x52\x41\x44\x20\x53\x74\x75\x64\x69\x6f\x20\x2d\x20\x43\x6f\x70\x79\x72\x69\x67\x68\x74\x20",35); // Embarcadero RAD Studio - Copyright 2009 Embarcadero Technologies, Inc.
+                        nOffset_EmbarcaderoCPP=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"Embarcadero RAD Studio - Copyright "); // Embarcadero RAD Studio - Copyright 2009 Embarcadero Technologies, Inc.
                     }
                 }
             }
@@ -4855,7 +5013,7 @@ void SpecAbstract::PE_handle_Borland(QIODevice *pDevice,bool bIsImage, SpecAbstr
 
                 if(bPackageinfo)
                 {
-                    VCL_PACKAGEINFO pi=PE_getVCLPackageInfo(pDevice,bIsImage,&pPEInfo->listResources);
+                    VCL_PACKAGEINFO pi=PE_getVCLPackageInfo(pDevice,bIsImage,&pPEInfo->peModel,&pPEInfo->listResources);
 
                     if(pi.listModules.count())
                     {
@@ -5141,6 +5299,7 @@ void SpecAbstract::PE_handle_Watcom(QIODevice *pDevice, bool bIsImage, SpecAbstr
 {
     // TODO Turbo Linker
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -5185,6 +5344,7 @@ void SpecAbstract::PE_handle_Watcom(QIODevice *pDevice, bool bIsImage, SpecAbstr
 void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -5252,11 +5412,9 @@ void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstrac
         // Flex
         if(XBinary::checkOffsetSize(pPEInfo->osDataSection)&&(pPEInfo->basic_info.bIsDeepScan))
         {
-            qint64 _nOffset=pPEInfo->osDataSection.nOffset;
-            qint64 _nSize=pPEInfo->osDataSection.nSize;
             // TODO FPC Version in Major and Minor linker
 
-            qint64 nOffset_FlexLM=pe.find_ansiString(_nOffset,_nSize,"@(#) FLEXlm ");
+            qint64 nOffset_FlexLM=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"@(#) FLEXlm ");
 
             if(nOffset_FlexLM!=-1)
             {
@@ -5278,12 +5436,12 @@ void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstrac
 
             if(nOffset_FlexLM==-1)
             {
-                nOffset_FlexNet=pe.find_ansiString(_nOffset,_nSize,"@(#) FLEXnet Licensing v");
+                nOffset_FlexNet=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"@(#) FLEXnet Licensing v");
             }
 
             if(nOffset_FlexNet==-1)
             {
-                nOffset_FlexNet=pe.find_ansiString(_nOffset,_nSize,"@(#) FlexNet Licensing v");
+                nOffset_FlexNet=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"@(#) FlexNet Licensing v");
             }
 
             if(nOffset_FlexNet!=-1)
@@ -5333,11 +5491,9 @@ void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstrac
 
             if(XBinary::checkOffsetSize(pPEInfo->osDataSection)&&(pPEInfo->basic_info.bIsDeepScan))
             {
-                qint64 _nOffset=pPEInfo->osDataSection.nOffset;
-                qint64 _nSize=pPEInfo->osDataSection.nSize;
                 // TODO FPC Version in Major and Minor linker
 
-                qint64 nOffset_FPC=pe.find_ansiString(_nOffset,_nSize,"FPC ");
+                qint64 nOffset_FPC=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"FPC ");
 
                 if(nOffset_FPC!=-1)
                 {
@@ -5348,7 +5504,7 @@ void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstrac
                     pPEInfo->mapResultCompilers.insert(ss.name,scansToScan(&(pPEInfo->basic_info),&ss));
 
                     // Lazarus
-                    qint64 nOffset_Lazarus=pe.find_ansiString(_nOffset,_nSize,"Lazarus LCL: ");
+                    qint64 nOffset_Lazarus=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"Lazarus LCL: ");
 
                     if(nOffset_Lazarus!=-1)
                     {
@@ -5371,7 +5527,7 @@ void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstrac
                     //                        // TODO Version
                     //                        pPEInfo->mapResultCompilers.insert(ss.name,scansToScan(&(pPEInfo->basic_info),&ss));
                     //                    }
-                    qint64 nOffset_RunTimeError=pe.find_array(_nOffset,_nSize,"\x0e\x52\x75\x6e\x74\x69\x6d\x65\x20\x65\x72\x72\x6f\x72\x20",15); // Runtime Error TODO: use findAnsiString
+                    qint64 nOffset_RunTimeError=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"\x0e\x52\x75\x6e\x74\x69\x6d\x65\x20\x65\x72\x72\x6f\x72\x20"); // Runtime Error TODO: use findAnsiString
 
                     if(nOffset_RunTimeError!=-1)
                     {
@@ -5435,11 +5591,9 @@ void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstrac
             // Virtual Pascal
             if(XBinary::checkOffsetSize(pPEInfo->osDataSection)&&(pPEInfo->basic_info.bIsDeepScan))
             {
-                qint64 _nOffset=pPEInfo->osDataSection.nOffset;
-                qint64 _nSize=pPEInfo->osDataSection.nSize;
                 // TODO VP Version in Major and Minor linker
 
-                qint64 nOffset_VP=pe.find_ansiString(_nOffset,_nSize,"Virtual Pascal - Copyright (C) "); // "Virtual Pascal - Copyright (C) 1996-2000 vpascal.com"
+                qint64 nOffset_VP=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"Virtual Pascal - Copyright (C) "); // "Virtual Pascal - Copyright (C) 1996-2000 vpascal.com"
 
                 if(nOffset_VP!=-1)
                 {
@@ -5454,11 +5608,9 @@ void SpecAbstract::PE_handle_Tools(QIODevice *pDevice,bool bIsImage, SpecAbstrac
             // PowerBASIC
             if(XBinary::checkOffsetSize(pPEInfo->osCodeSection)&&(pPEInfo->basic_info.bIsDeepScan))
             {
-                qint64 _nOffset=pPEInfo->osCodeSection.nOffset;
-                qint64 _nSize=pPEInfo->osCodeSection.nSize;
                 // TODO VP Version in Major and Minor linker
 
-                qint64 nOffset_PB=pe.find_ansiString(_nOffset,_nSize,"PowerBASIC");
+                qint64 nOffset_PB=findRegionProbe(&pe,&(pPEInfo->probeCodeSection),"PowerBASIC");
 
                 if(nOffset_PB!=-1)
                 {
@@ -5515,6 +5667,7 @@ void SpecAbstract::PE_handle_GCC(QIODevice *pDevice, bool bIsImage, SpecAbstract
     SpecAbstract::_SCANS_STRUCT recordTool= {};
 
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -5704,9 +5857,15 @@ void SpecAbstract::PE_handle_GCC(QIODevice *pDevice, bool bIsImage, SpecAbstract
 
                         bool bSuccess=false;
 
+                        QList<QByteArray> listStrings;
+                        listStrings.append("/gcc/mingw32/");
+                        listStrings.append("/gcc/i686-pc-cygwin/");
+
+                        QList<qint64> listOffsets=pe.find_arrays(_nOffset,_nSize,&listStrings);
+
                         if(!bSuccess)
                         {
-                            qint64 nGCC_MinGW=pe.find_ansiString(_nOffset,_nSize,"/gcc/mingw32/");
+                            qint64 nGCC_MinGW=listOffsets.at(0);
 
                             if(nGCC_MinGW!=-1)
                             {
@@ -5719,7 +5878,7 @@ void SpecAbstract::PE_handle_GCC(QIODevice *pDevice, bool bIsImage, SpecAbstract
 
                         if(!bSuccess)
                         {
-                            qint64 nCygwin=pe.find_ansiString(_nOffset,_nSize,"/gcc/i686-pc-cygwin/");
+                            qint64 nCygwin=listOffsets.at(1);
 
                             if(nCygwin!=-1)
                             {
@@ -5798,6 +5957,7 @@ void SpecAbstract::PE_handle_GCC(QIODevice *pDevice, bool bIsImage, SpecAbstract
 void SpecAbstract::PE_handle_Signtools(QIODevice *pDevice, bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -5818,6 +5978,7 @@ void SpecAbstract::PE_handle_Signtools(QIODevice *pDevice, bool bIsImage, SpecAb
 void SpecAbstract::PE_handle_Installers(QIODevice *pDevice,bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -5834,10 +5995,7 @@ void SpecAbstract::PE_handle_Installers(QIODevice *pDevice,bool bIsImage, SpecAb
 
                     if(XBinary::checkOffsetSize(pPEInfo->osCodeSection)&&(pPEInfo->basic_info.bIsDeepScan))
                     {
-                        qint64 _nOffset=pPEInfo->osCodeSection.nOffset;
-                        qint64 _nSize=pPEInfo->osCodeSection.nSize;
-
-                        qint64 nOffsetVersion=pe.find_ansiString(_nOffset,_nSize,"Setup version: Inno Setup version ");
+                        qint64 nOffsetVersion=findRegionProbe(&pe,&(pPEInfo->probeCodeSection),"Setup version: Inno Setup version ");
 
                         if(nOffsetVersion!=-1)
                         {
@@ -5859,10 +6017,8 @@ void SpecAbstract::PE_handle_Installers(QIODevice *pDevice,bool bIsImage, SpecAb
                 else if(pPEInfo->mapOverlayDetects.value(RECORD_NAME_INNOSETUP).sInfo=="Uninstall")
                 {
                     ss.sInfo="Uninstall";
-                    qint64 _nOffset=pPEInfo->nOverlayOffset;
-                    qint64 _nSize=pPEInfo->nOverlaySize;
 
-                    qint64 nOffsetVersion=pe.find_ansiString(_nOffset,_nSize,"Inno Setup Messages (");
+                    qint64 nOffsetVersion=findRegionProbe(&pe,&(pPEInfo->probeOverlay),"Inno Setup Messages (");
 
                     if(nOffsetVersion!=-1)
                     {
@@ -6083,10 +6239,7 @@ void SpecAbstract::PE_handle_Installers(QIODevice *pDevice,bool bIsImage, SpecAb
 
                 if(XBinary::checkOffsetSize(pPEInfo->osDataSection)&&(pPEInfo->basic_info.bIsDeepScan))
                 {
-                    qint64 _nOffset=pPEInfo->osDataSection.nOffset;
-                    qint64 _nSize=pPEInfo->osDataSection.nSize;
-
-                    qint64 nOffsetVersion=pe.find_ansiString(_nOffset,_nSize,"SOFTWARE\\InstallShield\\1");
+                    qint64 nOffsetVersion=findRegionProbe(&pe,&(pPEInfo->probeDataSection),"SOFTWARE\\InstallShield\\1");
 
                     if(nOffsetVersion!=-1)
                     {
@@ -6110,10 +6263,7 @@ void SpecAbstract::PE_handle_Installers(QIODevice *pDevice,bool bIsImage, SpecAb
 
                 if((pPEInfo->nOverlayOffset)&&(pPEInfo->nOverlaySize)&&(pPEInfo->basic_info.bIsDeepScan))
                 {
-                    qint64 _nOffset=pPEInfo->nOverlayOffset;
-                    qint64 _nSize=pPEInfo->nOverlaySize;
-
-                    qint64 nOffsetVersion=pe.find_ansiString(_nOffset,_nSize,"Advanced Installer ");
+                    qint64 nOffsetVersion=findRegionProbe(&pe,&(pPEInfo->probeOverlay),"Advanced Installer ");
 
                     if(nOffsetVersion!=-1)
                     {
@@ -6281,6 +6431,7 @@ void SpecAbstract::PE_handle_Installers(QIODevice *pDevice,bool bIsImage, SpecAb
 void SpecAbstract::PE_handle_SFX(QIODevice *pDevice,bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo)
 {
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -6426,6 +6577,7 @@ void SpecAbstract::PE_handle_Recursive(QIODevice *pDevice, bool bIsImage, SpecAb
     if(pOptions->bRecursive)
     {
         XPE pe(pDevice,bIsImage);
+        pe.setModel(&pPEInfo->peModel);
 
         if(pe.isValid())
         {
@@ -6443,6 +6595,313 @@ void SpecAbstract::PE_handle_Recursive(QIODevice *pDevice, bool bIsImage, SpecAb
     }
 }
 
+QList<SpecAbstract::PE_HANDLER_RECORD> SpecAbstract::PE_getHandlers()
+{
+    // The handlers run in this order. The flags are kept by hand and have to follow the handler bodies:
+    // debug builds check the writes of the parallel groups (PE_runHandlers), the reads cannot be checked
+    const PE_HANDLER_RECORD records[]=
+    {
+        {PE_handle_import,              PE_RESULTMAP_IMPORTDETECTS,                                                                         PE_RESULTMAP_IMPORTDETECTS},
+        {PE_handle_Protection,          PE_RESULTMAP_IMPORTDETECTS|PE_RESULTMAP_PACKERS|PE_RESULTMAP_PROTECTORS,                            PE_RESULTMAP_PACKERS|PE_RESULTMAP_PROTECTORS},
+        {PE_handle_VMProtect,           PE_RESULTMAP_PROTECTORS,                                                                            PE_RESULTMAP_PROTECTORS},
+        {PE_handle_Armadillo,           PE_RESULTMAP_PROTECTORS,                                                                            PE_RESULTMAP_PROTECTORS},
+        {PE_handle_Obsidium,            0,                                                                                                  0},
+        {PE_handle_StarForce,           PE_RESULTMAP_PROTECTORS,                                                                            PE_RESULTMAP_PROTECTORS},
+        {PE_handle_Petite,              PE_RESULTMAP_PACKERS,                                                                               PE_RESULTMAP_PACKERS},
+        {PE_handle_NETProtection,       PE_RESULTMAP_NETOBFUSCATORS|PE_RESULTMAP_PACKERS|PE_RESULTMAP_PROTECTORS,                           PE_RESULTMAP_NETOBFUSCATORS|PE_RESULTMAP_PACKERS|PE_RESULTMAP_PROTECTORS},
+        {PE_handle_PolyMorph,           0,                                                                                                  0},
+        {PE_handle_Microsoft,           PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LIBRARIES|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS,              PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LIBRARIES|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS},
+        {PE_handle_Borland,             PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS,                                     PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS},
+        {PE_handle_Watcom,              PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS,                                                        PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS},
+        {PE_handle_Tools,               PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LIBRARIES|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS,              PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LIBRARIES|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS},
+        {PE_handle_GCC,                 PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS,                                     PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS},
+        {PE_handle_Signtools,           PE_RESULTMAP_SIGNTOOLS,                                                                             PE_RESULTMAP_SIGNTOOLS},
+        {PE_handle_SFX,                 PE_RESULTMAP_SFX,                                                                                   PE_RESULTMAP_SFX},
+        {PE_handle_Installers,          PE_RESULTMAP_INSTALLERS,                                                                            PE_RESULTMAP_INSTALLERS},
+        {PE_handle_DongleProtection,    PE_RESULTMAP_SFX,                                                                                   PE_RESULTMAP_SFX},
+        {PE_handle_UnknownProtection,   PE_RESULTMAP_IMPORTDETECTS|PE_RESULTMAP_PACKERS|PE_RESULTMAP_PROTECTORS,                            PE_RESULTMAP_PACKERS},
+        {PE_handle_FixDetects,          PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS|PE_RESULTMAP_PACKERS|PE_RESULTMAP_TOOLS,                PE_RESULTMAP_COMPILERS|PE_RESULTMAP_LINKERS|PE_RESULTMAP_TOOLS}
+    };
+
+    QList<PE_HANDLER_RECORD> listResult;
+
+    for(int i=0;i<(int)(sizeof(records)/sizeof(PE_HANDLER_RECORD));i++)
+    {
+        listResult.append(records[i]);
+    }
+
+    return listResult;
+}
+
+void SpecAbstract::PE_copyResults(SpecAbstract::PEINFO_STRUCT *pDest, const SpecAbstract::PEINFO_STRUCT *pSource, quint32 nMaps)
+{
+    if(nMaps&PE_RESULTMAP_IMPORTDETECTS)
+    {
+        pDest->mapImportDetects=pSource->mapImportDetects;
+    }
+
+    if(nMaps&PE_RESULTMAP_LINKERS)
+    {
+        pDest->mapResultLinkers=pSource->mapResultLinkers;
+    }
+
+    if(nMaps&PE_RESULTMAP_COMPILERS)
+    {
+        pDest->mapResultCompilers=pSource->mapResultCompilers;
+    }
+
+    if(nMaps&PE_RESULTMAP_LIBRARIES)
+    {
+        pDest->mapResultLibraries=pSource->mapResultLibraries;
+    }
+
+    if(nMaps&PE_RESULTMAP_TOOLS)
+    {
+        pDest->mapResultTools=pSource->mapResultTools;
+    }
+
+    if(nMaps&PE_RESULTMAP_SIGNTOOLS)
+    {
+        pDest->mapResultSigntools=pSource->mapResultSigntools;
+    }
+
+    if(nMaps&PE_RESULTMAP_PROTECTORS)
+    {
+        pDest->mapResultProtectors=pSource->mapResultProtectors;
+    }
+
+    if(nMaps&PE_RESULTMAP_PACKERS)
+    {
+        pDest->mapResultPackers=pSource->mapResultPackers;
+    }
+
+    if(nMaps&PE_RESULTMAP_INSTALLERS)
+    {
+        pDest->mapResultInstallers=pSource->mapResultInstallers;
+    }
+
+    if(nMaps&PE_RESULTMAP_SFX)
+    {
+        pDest->mapResultSFX=pSource->mapResultSFX;
+    }
+
+    if(nMaps&PE_RESULTMAP_NETOBFUSCATORS)
+    {
+        pDest->mapResultNETObfuscators=pSource->mapResultNETObfuscators;
+    }
+
+    if(nMaps&PE_RESULTMAP_DONGLEPROTECTION)
+    {
+        pDest->mapResultDongleProtection=pSource->mapResultDongleProtection;
+    }
+}
+
+#ifndef QT_NO_DEBUG
+// The maps of a copy that the handlers did not write to still share their data with the original
+static quint32 _PE_getWrittenMaps(const SpecAbstract::PEINFO_STRUCT *pOriginal,const SpecAbstract::PEINFO_STRUCT *pCopy)
+{
+    quint32 nResult=0;
+
+    if(!pCopy->mapImportDetects.isSharedWith(pOriginal->mapImportDetects))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_IMPORTDETECTS;
+    }
+
+    if(!pCopy->mapResultLinkers.isSharedWith(pOriginal->mapResultLinkers))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_LINKERS;
+    }
+
+    if(!pCopy->mapResultCompilers.isSharedWith(pOriginal->mapResultCompilers))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_COMPILERS;
+    }
+
+    if(!pCopy->mapResultLibraries.isSharedWith(pOriginal->mapResultLibraries))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_LIBRARIES;
+    }
+
+    if(!pCopy->mapResultTools.isSharedWith(pOriginal->mapResultTools))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_TOOLS;
+    }
+
+    if(!pCopy->mapResultSigntools.isSharedWith(pOriginal->mapResultSigntools))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_SIGNTOOLS;
+    }
+
+    if(!pCopy->mapResultProtectors.isSharedWith(pOriginal->mapResultProtectors))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_PROTECTORS;
+    }
+
+    if(!pCopy->mapResultPackers.isSharedWith(pOriginal->mapResultPackers))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_PACKERS;
+    }
+
+    if(!pCopy->mapResultInstallers.isSharedWith(pOriginal->mapResultInstallers))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_INSTALLERS;
+    }
+
+    if(!pCopy->mapResultSFX.isSharedWith(pOriginal->mapResultSFX))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_SFX;
+    }
+
+    if(!pCopy->mapResultNETObfuscators.isSharedWith(pOriginal->mapResultNETObfuscators))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_NETOBFUSCATORS;
+    }
+
+    if(!pCopy->mapResultDongleProtection.isSharedWith(pOriginal->mapResultDongleProtection))
+    {
+        nResult|=SpecAbstract::PE_RESULTMAP_DONGLEPROTECTION;
+    }
+
+    return nResult;
+}
+#endif
+
+class _PE_HANDLER_GROUP : public QRunnable
+{
+public:
+    _PE_HANDLER_GROUP(QIODevice *pDevice,bool bIsImage,const SpecAbstract::PEINFO_STRUCT *pPEInfo) :
+        pDevice(pDevice),
+        bIsImage(bIsImage),
+        peInfo(*pPEInfo),
+        nWrites(0),
+        pIdCounter(_ID_SCOPE::getCurrent()),
+        pSemaphoreDone(nullptr)
+    {
+        setAutoDelete(false);
+    }
+
+    void run()
+    {
+        // A pool thread has no scan of its own: it takes an arena and goes on with the IDs of the scan
+        XArenaScope arenaScope;
+        _ID_SCOPE idScope(pIdCounter);
+
+        for(int i=0;i<listHandlers.count();i++)
+        {
+            listHandlers.at(i)(pDevice,bIsImage,&peInfo);
+        }
+
+        if(pSemaphoreDone)
+        {
+            pSemaphoreDone->release();
+        }
+    }
+
+    QIODevice *pDevice;
+    bool bIsImage;
+    SpecAbstract::PEINFO_STRUCT peInfo; // Own copy of the maps; the region probe results are shared
+    QList<SpecAbstract::PE_HANDLER> listHandlers;
+    quint32 nWrites;
+    _ID_COUNTER *pIdCounter;
+    QSemaphore *pSemaphoreDone;
+};
+
+// One pool for all files: the threads are not started and joined per file
+Q_GLOBAL_STATIC(QThreadPool,_pe_handler_pool)
+
+void SpecAbstract::PE_runHandlers(QIODevice *pDevice, bool bIsImage, SpecAbstract::PEINFO_STRUCT *pPEInfo, bool bParallel)
+{
+    QList<PE_HANDLER_RECORD> listHandlers=PE_getHandlers();
+
+    // Concurrent reads are only safe when the data is in memory; other devices share one position
+    if(bParallel&&XBinary::getDeviceMemory(pDevice))
+    {
+        QThreadPool *pThreadPool=_pe_handler_pool();
+
+        int nIndex=0;
+
+        while(nIndex<listHandlers.count())
+        {
+            // A handler joins the group that owns the maps it uses, so every map has one writer in a stage.
+            // A handler that needs maps of two groups waits for the stage to be merged.
+            QList<_PE_HANDLER_GROUP *> listGroups;
+
+            for(; nIndex<listHandlers.count(); nIndex++)
+            {
+                quint32 nMaps=listHandlers.at(nIndex).nReads|listHandlers.at(nIndex).nWrites;
+
+                _PE_HANDLER_GROUP *pGroup=0;
+                bool bNextStage=false;
+
+                for(int i=0;i<listGroups.count();i++)
+                {
+                    if(listGroups.at(i)->nWrites&nMaps)
+                    {
+                        if(pGroup)
+                        {
+                            bNextStage=true;
+                            break;
+                        }
+
+                        pGroup=listGroups.at(i);
+                    }
+                }
+
+                if(bNextStage)
+                {
+                    break;
+                }
+
+                if(!pGroup)
+                {
+                    pGroup=new _PE_HANDLER_GROUP(pDevice,bIsImage,pPEInfo);
+                    listGroups.append(pGroup);
+                }
+
+                pGroup->listHandlers.append(listHandlers.at(nIndex).pHandler);
+                pGroup->nWrites|=listHandlers.at(nIndex).nWrites;
+            }
+
+            // The pool is shared by the files scanned at the same time, so only the groups of this stage are waited for
+            QSemaphore semaphoreDone;
+
+            for(int i=1;i<listGroups.count();i++)
+            {
+                listGroups.at(i)->pSemaphoreDone=&semaphoreDone;
+                pThreadPool->start(listGroups.at(i));
+            }
+
+            listGroups.at(0)->run();
+
+            semaphoreDone.acquire(listGroups.count()-1);
+
+#ifndef QT_NO_DEBUG
+            for(int i=0;i<listGroups.count();i++)
+            {
+                // A write to a map that is not declared would be lost in the merge
+                Q_ASSERT_X(!(_PE_getWrittenMaps(pPEInfo,&(listGroups.at(i)->peInfo))&~(listGroups.at(i)->nWrites)),
+                           "PE_runHandlers","a handler writes a map that PE_getHandlers does not declare");
+            }
+#endif
+
+            // The maps of the groups do not overlap, so the merge order does not matter
+            for(int i=0;i<listGroups.count();i++)
+            {
+                PE_copyResults(pPEInfo,&(listGroups.at(i)->peInfo),listGroups.at(i)->nWrites);
+            }
+
+            qDeleteAll(listGroups);
+        }
+    }
+    else
+    {
+        for(int i=0;i<listHandlers.count();i++)
+        {
+            listHandlers.at(i).pHandler(pDevice,bIsImage,pPEInfo);
+        }
+    }
+}
+
 void SpecAbstract::Binary_handle_Texts(QIODevice *pDevice,bool bIsImage, SpecAbstract::BINARYINFO_STRUCT *pBinaryInfo)
 {
     XBinary binary(pDevice);
@@ -6461,8 +6920,8 @@ void SpecAbstract::Binary_handle_Texts(QIODevice *pDevice,bool bIsImage, SpecAbs
                 record.filetype=_TEXT_records[i].filetype;
                 record.type=_TEXT_records[i].type;
                 record.name=_TEXT_records[i].name;
-                record.sVersion=_TEXT_records[i].pszVersion;
-                record.sInfo=_TEXT_records[i].pszInfo;
+                record.sVersion=getPoolString(_TEXT_records[i].pszVersion);
+                record.sInfo=getPoolString(_TEXT_records[i].pszInfo);
                 record.nOffset=0;
 
                 pBinaryInfo->mapTextHeaderDetects.insert(record.name,record);
@@ -7616,34 +8075,29 @@ void SpecAbstract::MACH_handle_Protection(QIODevice *pDevice, bool bIsImage, Spe
 //    }
 //}
 
-void SpecAbstract::updateVersion(QMap<SpecAbstract::RECORD_NAME, SpecAbstract::SCAN_STRUCT> *map, SpecAbstract::RECORD_NAME name, QString sVersion)
+void SpecAbstract::updateVersion(SpecAbstract::DETECTSET<SpecAbstract::SCAN_STRUCT> *map, SpecAbstract::RECORD_NAME name, QString sVersion)
 {
     if(map->contains(name))
     {
-        SpecAbstract::SCAN_STRUCT record=map->value(name);
-        record.sVersion=sVersion;
-        map->insert(name,record);
+        (*map)[name].sVersion=sVersion;
     }
 }
 
-void SpecAbstract::updateInfo(QMap<SpecAbstract::RECORD_NAME, SpecAbstract::SCAN_STRUCT> *map, SpecAbstract::RECORD_NAME name, QString sInfo)
+void SpecAbstract::updateInfo(SpecAbstract::DETECTSET<SpecAbstract::SCAN_STRUCT> *map, SpecAbstract::RECORD_NAME name, QString sInfo)
 {
     if(map->contains(name))
     {
-        SpecAbstract::SCAN_STRUCT record=map->value(name);
-        record.sInfo=sInfo;
-        map->insert(name,record);
+        (*map)[name].sInfo=sInfo;
     }
 }
 
-void SpecAbstract::updateVersionAndInfo(QMap<SpecAbstract::RECORD_NAME, SpecAbstract::SCAN_STRUCT> *map, SpecAbstract::RECORD_NAME name, QString sVersion, QString sInfo)
+void SpecAbstract::updateVersionAndInfo(SpecAbstract::DETECTSET<SpecAbstract::SCAN_STRUCT> *map, SpecAbstract::RECORD_NAME name, QString sVersion, QString sInfo)
 {
     if(map->contains(name))
     {
-        SpecAbstract::SCAN_STRUCT record=map->value(name);
-        record.sVersion=sVersion;
-        record.sInfo=sInfo;
-        map->insert(name,record);
+        SpecAbstract::SCAN_STRUCT *pRecord=&((*map)[name]);
+        pRecord->sVersion=sVersion;
+        pRecord->sInfo=sInfo;
     }
 }
 
@@ -7703,9 +8157,21 @@ SpecAbstract::VI_STRUCT SpecAbstract::get_UPX_vi(QIODevice *pDevice, bool bIsIma
 
     XBinary binary(pDevice);
 
-    // TODO make both
-    qint64 nStringOffset1=binary.find_array(nOffset,nSize,"$Id: UPX",9);
-    qint64 nStringOffset2=binary.find_ansiString(nOffset,nSize,"UPX!");
+    // The header is searched in place
+    XBinary::DATAVIEW dvHeader=binary.getDataView(nOffset,nSize);
+
+    qint64 nStringOffset1=XBinary::_findMemory(dvHeader.pData,dvHeader.nSize,"$Id: UPX",9);
+    qint64 nStringOffset2=XBinary::_findMemory(dvHeader.pData,dvHeader.nSize,"UPX!",4);
+
+    if(nStringOffset1!=-1)
+    {
+        nStringOffset1+=nOffset;
+    }
+
+    if(nStringOffset2!=-1)
+    {
+        nStringOffset2+=nOffset;
+    }
 
     if(nStringOffset1!=-1)
     {
@@ -7718,10 +8184,12 @@ SpecAbstract::VI_STRUCT SpecAbstract::get_UPX_vi(QIODevice *pDevice, bool bIsIma
         }
 
         // NRV
-        qint64 nNRVStringOffset1=binary.find_array(nOffset,nSize,"\x24\x49\x64\x3a\x20\x4e\x52\x56\x20",9);
+        qint64 nNRVStringOffset1=XBinary::_findMemory(dvHeader.pData,dvHeader.nSize,"\x24\x49\x64\x3a\x20\x4e\x52\x56\x20",9);
 
         if(nNRVStringOffset1!=-1)
         {
+            nNRVStringOffset1+=nOffset;
+
             QString sNRVVersion=binary.read_ansiString(nNRVStringOffset1+9,10);
             sNRVVersion=sNRVVersion.section(" ",0,0);
 
@@ -7798,6 +8266,7 @@ SpecAbstract::VI_STRUCT SpecAbstract::PE_get_Armadillo_vi(QIODevice *pDevice,boo
     VI_STRUCT result;
 
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -10441,13 +10910,119 @@ SpecAbstract::BASIC_PE_INFO SpecAbstract::_ArrayToBasicPEInfo(const QByteArray *
     return result;
 }
 
-void SpecAbstract::memoryScan(QMap<RECORD_NAME, _SCANS_STRUCT> *pMmREcords, QIODevice *pDevice, bool bIsImage, qint64 nOffset, qint64 nSize, SpecAbstract::SCANMEMORY_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
+struct _STRING_POOL
+{
+    // Version and info strings of a record table, by record index
+    struct TABLE
+    {
+        QVector<QString> listVersions;
+        QVector<QString> listInfos;
+    };
+
+    QReadWriteLock lock;
+    QHash<const char *,QString> mapPointers;
+    QSet<QString> stStrings;
+
+    QReadWriteLock lockTables;
+    QHash<const void *,TABLE *> mapTables;
+
+    ~_STRING_POOL()
+    {
+        qDeleteAll(mapTables);
+    }
+};
+
+Q_GLOBAL_STATIC(_STRING_POOL,_string_pool)
+
+QString SpecAbstract::getPoolString(const char *pszString)
+{
+    if((!pszString)||(!(*pszString)))
+    {
+        return QString();
+    }
+
+    _STRING_POOL *pPool=_string_pool();
+
+    {
+        QReadLocker locker(&(pPool->lock));
+
+        QHash<const char *,QString>::const_iterator iter=pPool->mapPointers.constFind(pszString);
+
+        if(iter!=pPool->mapPointers.constEnd())
+        {
+            return iter.value();
+        }
+    }
+
+    QWriteLocker locker(&(pPool->lock));
+
+    // The same text may come from different literals
+    QString sResult=QString::fromUtf8(pszString);
+    QSet<QString>::const_iterator iter=pPool->stStrings.constFind(sResult);
+
+    if(iter!=pPool->stStrings.constEnd())
+    {
+        sResult=*iter;
+    }
+    else
+    {
+        pPool->stStrings.insert(sResult);
+    }
+
+    pPool->mapPointers.insert(pszString,sResult);
+
+    return sResult;
+}
+
+// The pool strings of a record table are looked up once, the matches copy them without allocating
+template<class T>
+static const _STRING_POOL::TABLE *_getPoolTable(const T *pRecords,int nRecordsCount)
+{
+    _STRING_POOL *pPool=_string_pool();
+
+    // Built once per table; after that the scans only share a read lock
+    {
+        QReadLocker locker(&(pPool->lockTables));
+
+        _STRING_POOL::TABLE *pResult=pPool->mapTables.value(pRecords);
+
+        if(pResult)
+        {
+            return pResult;
+        }
+    }
+
+    QWriteLocker locker(&(pPool->lockTables));
+
+    _STRING_POOL::TABLE *pResult=pPool->mapTables.value(pRecords);
+
+    if(!pResult)
+    {
+        pResult=new _STRING_POOL::TABLE;
+        pResult->listVersions.resize(nRecordsCount);
+        pResult->listInfos.resize(nRecordsCount);
+
+        for(int i=0; i<nRecordsCount; i++)
+        {
+            pResult->listVersions[i]=SpecAbstract::getPoolString(pRecords[i].pszVersion);
+            pResult->listInfos[i]=SpecAbstract::getPoolString(pRecords[i].pszInfo);
+        }
+
+        pPool->mapTables.insert(pRecords,pResult);
+    }
+
+    return pResult;
+}
+
+void SpecAbstract::memoryScan(SpecAbstract::DETECTSET<_SCANS_STRUCT> *pMmREcords, QIODevice *pDevice, bool bIsImage, qint64 nOffset, qint64 nSize, SpecAbstract::SCANMEMORY_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
 {
     if(nSize)
     {
         XBinary binary(pDevice,bIsImage);
 
-        int nSignaturesCount=nRecordsSize/sizeof(SIGNATURE_RECORD);
+        int nSignaturesCount=nRecordsSize/sizeof(SCANMEMORY_RECORD);
+
+        const _STRING_POOL::TABLE *pPoolTable=_getPoolTable(pRecords,nSignaturesCount);
 
         for(int i=0; i<nSignaturesCount; i++)
         {
@@ -10464,8 +11039,8 @@ void SpecAbstract::memoryScan(QMap<RECORD_NAME, _SCANS_STRUCT> *pMmREcords, QIOD
                         record.filetype=pRecords[i].filetype;
                         record.type=pRecords[i].type;
                         record.name=pRecords[i].name;
-                        record.sVersion=pRecords[i].pszVersion;
-                        record.sInfo=pRecords[i].pszInfo;
+                        record.sVersion=pPoolTable->listVersions.at(i);
+                        record.sInfo=pPoolTable->listInfos.at(i);
                         record.nOffset=_nOffset;
 
                         pMmREcords->insert(record.name,record);
@@ -10476,39 +11051,65 @@ void SpecAbstract::memoryScan(QMap<RECORD_NAME, _SCANS_STRUCT> *pMmREcords, QIOD
     }
 }
 
-void SpecAbstract::signatureScan(QMap<RECORD_NAME, _SCANS_STRUCT> *pMapRecords, QString sSignature, SpecAbstract::SIGNATURE_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
+void SpecAbstract::signatureScan(SpecAbstract::DETECTSET<_SCANS_STRUCT> *pMapRecords, const QByteArray *pbaData, const SpecAbstract::SIGNATURE_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
 {
-    int nSignaturesCount=nRecordsSize/sizeof(SIGNATURE_RECORD);
+    const SIGNATURE_TABLE *pTable=getSignatureTable(pRecords,nRecordsSize);
+    const _STRING_POOL::TABLE *pPoolTable=_getPoolTable(pRecords,nRecordsSize/sizeof(SIGNATURE_RECORD));
 
-    for(int i=0; i<nSignaturesCount; i++)
+    QList<qint32> listMatches=matchSignatureTable(pTable,pbaData);
+
+    int nUncompiledCount=pTable->listUncompiled.count();
+
+    if(nUncompiledCount)
     {
+        QString sSignature=pbaData->toHex();
+
+        for(int i=0; i<nUncompiledCount; i++)
+        {
+            qint32 nIndex=pTable->listUncompiled.at(i);
+
+            if(XBinary::compareSignatureStrings(sSignature,pRecords[nIndex].signature.pszString))
+            {
+                listMatches.append(nIndex);
+            }
+        }
+    }
+
+    // The first record in the table wins
+    std::sort(listMatches.begin(),listMatches.end());
+
+    int nMatchesCount=listMatches.count();
+
+    for(int j=0; j<nMatchesCount; j++)
+    {
+        int i=listMatches.at(j);
+
         if((pRecords[i].filetype==fileType1)||(pRecords[i].filetype==fileType2))
         {
             if(!pMapRecords->contains(pRecords[i].name))
             {
-                if(XBinary::compareSignatureStrings(sSignature,pRecords[i].pszSignature))
-                {
-                    SpecAbstract::_SCANS_STRUCT record= {};
-                    record.nVariant=pRecords[i].nVariant;
-                    record.filetype=pRecords[i].filetype;
-                    record.type=pRecords[i].type;
-                    record.name=pRecords[i].name;
-                    record.sVersion=pRecords[i].pszVersion;
-                    record.sInfo=pRecords[i].pszInfo;
+                SpecAbstract::_SCANS_STRUCT record= {};
+                record.nVariant=pRecords[i].nVariant;
+                record.filetype=pRecords[i].filetype;
+                record.type=pRecords[i].type;
+                record.name=pRecords[i].name;
+                record.sVersion=pPoolTable->listVersions.at(i);
+                record.sInfo=pPoolTable->listInfos.at(i);
 
-                    record.nOffset=0;
+                record.nOffset=0;
 
-                    pMapRecords->insert(record.name,record);
-                }
+                pMapRecords->insert(record.name,record);
             }
         }
     }
 }
 
-void SpecAbstract::resourcesScan(QMap<SpecAbstract::RECORD_NAME, SpecAbstract::_SCANS_STRUCT> *pMapRecords, QList<XPE::RESOURCE_RECORD> *pListResources, SpecAbstract::RESOURCES_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
+void SpecAbstract::resourcesScan(SpecAbstract::DETECTSET<SpecAbstract::_SCANS_STRUCT> *pMapRecords, QList<XPE::RESOURCE_RECORD> *pListResources, SpecAbstract::RESOURCES_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
 {
     int nSignaturesCount=nRecordsSize/sizeof(RESOURCES_RECORD);
 
+    const _STRING_POOL::TABLE *pPoolTable=_getPoolTable(pRecords,nSignaturesCount);
+
     for(int i=0; i<nSignaturesCount; i++)
     {
         if((pRecords[i].filetype==fileType1)||(pRecords[i].filetype==fileType2))
@@ -10547,8 +11148,8 @@ void SpecAbstract::resourcesScan(QMap<SpecAbstract::RECORD_NAME, SpecAbstract::_
                     record.filetype=pRecords[i].filetype;
                     record.type=pRecords[i].type;
                     record.name=pRecords[i].name;
-                    record.sVersion=pRecords[i].pszVersion;
-                    record.sInfo=pRecords[i].pszInfo;
+                    record.sVersion=pPoolTable->listVersions.at(i);
+                    record.sInfo=pPoolTable->listInfos.at(i);
                     record.nOffset=0;
 
                     pMapRecords->insert(record.name,record);
@@ -10558,74 +11159,361 @@ void SpecAbstract::resourcesScan(QMap<SpecAbstract::RECORD_NAME, SpecAbstract::_
     }
 }
 
-void SpecAbstract::stringScan(QMap<SpecAbstract::RECORD_NAME, SpecAbstract::_SCANS_STRUCT> *pMapRecords, QList<QString> *pListStrings, SpecAbstract::STRING_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
+void SpecAbstract::stringScan(SpecAbstract::DETECTSET<SpecAbstract::_SCANS_STRUCT> *pMapRecords, const QVector<XBinary::STRING_VIEW> *pListStrings, SpecAbstract::STRING_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2)
 {
-    QList<quint32> listStringCRC;
-    QList<quint32> listSignatureCRC;
-
     int nCount=pListStrings->count();
     int nSignaturesCount=nRecordsSize/sizeof(STRING_RECORD);
 
+    const STRING_TABLE *pTable=getStringTable(pRecords,nRecordsSize);
+    const _STRING_POOL::TABLE *pPoolTable=_getPoolTable(pRecords,nSignaturesCount);
+
+    // One lookup per string, without a copy of it; the strings come in file order, the records of a string in table order
     for(int i=0; i<nCount; i++)
     {
-        quint32 nCRC=XBinary::getCRC32(pListStrings->at(i));
-        listStringCRC.append(nCRC);
+        QHash<XBinary::STRING_VIEW,QList<qint32> >::const_iterator iter=pTable->mapIndexes.constFind(pListStrings->at(i));
+
+        if(iter==pTable->mapIndexes.constEnd())
+        {
+            continue;
+        }
+
+        const QList<qint32> *pListIndexes=&(iter.value());
+        int nIndexesCount=pListIndexes->count();
+
+        for(int k=0; k<nIndexesCount; k++)
+        {
+            int j=pListIndexes->at(k);
+
+            if((pRecords[j].filetype==fileType1)||(pRecords[j].filetype==fileType2))
+            {
+                if(!pMapRecords->contains(pRecords[j].name))
+                {
+                    SpecAbstract::_SCANS_STRUCT record= {};
+                    record.nVariant=pRecords[j].nVariant;
+                    record.filetype=pRecords[j].filetype;
+                    record.type=pRecords[j].type;
+                    record.name=pRecords[j].name;
+                    record.sVersion=pPoolTable->listVersions.at(j);
+                    record.sInfo=pPoolTable->listInfos.at(j);
+
+                    record.nOffset=0;
+
+                    pMapRecords->insert(record.name,record);
+                }
+            }
+        }
     }
+}
 
-    for(int i=0; i<nSignaturesCount; i++)
+SpecAbstract::REGION_PROBE SpecAbstract::createRegionProbe(qint64 nOffset, qint64 nSize, const char **ppszStrings, int nStringsSize)
+{
+    REGION_PROBE result= {};
+
+    result.nOffset=nOffset;
+    result.nSize=nSize;
+
+    int nStringsCount=nStringsSize/sizeof(const char *);
+
+    for(int i=0; i<nStringsCount; i++)
     {
-        quint32 nCRC=XBinary::getCRC32(pRecords[i].pszString);
-        listSignatureCRC.append(nCRC);
+        result.listArrays.append(QByteArray(ppszStrings[i]));
     }
 
-    for(int i=0; i<nCount; i++)
+    result.pResult=QSharedPointer<REGION_PROBE_RESULT>(new REGION_PROBE_RESULT);
+    result.pResult->bIsSearched=false;
+
+    return result;
+}
+
+qint64 SpecAbstract::findRegionProbe(XBinary *pBinary, SpecAbstract::REGION_PROBE *pProbe, const char *pszString)
+{
+    qint64 nResult=-1;
+
+    int nIndex=pProbe->listArrays.indexOf(QByteArray(pszString));
+
+    if(nIndex!=-1)
     {
-        for(int j=0; j<nSignaturesCount; j++)
+        REGION_PROBE_RESULT *pResult=pProbe->pResult.data();
+
+        bool bIsSearched=false;
+
         {
-            if((pRecords[j].filetype==fileType1)||(pRecords[j].filetype==fileType2))
+            QMutexLocker locker(&(pResult->mutex));
+
+            bIsSearched=pResult->bIsSearched;
+
+            if(bIsSearched)
             {
-                if(!pMapRecords->contains(pRecords[j].name))
+                nResult=pResult->listOffsets.at(nIndex);
+            }
+        }
+
+        if(!bIsSearched)
+        {
+            // The first request searches the region once for all strings, outside the lock: a parallel handler group
+            // that asks before the result is published sweeps too instead of waiting, and the first result is kept
+            QList<qint64> listOffsets=pBinary->find_arrays(pProbe->nOffset,pProbe->nSize,&(pProbe->listArrays));
+
+            QMutexLocker locker(&(pResult->mutex));
+
+            if(!pResult->bIsSearched)
+            {
+                pResult->listOffsets=listOffsets;
+                pResult->bIsSearched=true;
+            }
+
+            nResult=pResult->listOffsets.at(nIndex);
+        }
+    }
+    else
+    {
+        nResult=pBinary->find_array(pProbe->nOffset,pProbe->nSize,pszString,strlen(pszString));
+    }
+
+    return nResult;
+}
+
+SpecAbstract::SIGNATURE_TABLE SpecAbstract::compileSignatureTable(const SpecAbstract::SIGNATURE_RECORD *pRecords, int nRecordsSize)
+{
+    SIGNATURE_TABLE result;
+
+    result.listNodes.append(SIGNATURE_NODE());
+
+    int nSignaturesCount=nRecordsSize/sizeof(SIGNATURE_RECORD);
+
+    for(int i=0; i<nSignaturesCount; i++)
+    {
+        const SIGNATURE_LITERAL *pSignature=&(pRecords[i].signature);
+
+        if(!pSignature->bIsValid)
+        {
+            result.listUncompiled.append(i);
+
+            continue;
+        }
+
+        // Records share nodes while their bytes and masks are the same
+        qint32 nNode=0;
+        int nSize=pSignature->nSize;
+
+        for(int j=0; j<nSize; j++)
+        {
+            quint8 nData=pSignature->nData[j];
+            quint8 nMask=pSignature->nMask[j];
+
+            qint32 nNext=-1;
+            int nEdgesCount=result.listNodes.at(nNode).listEdges.count();
+
+            for(int k=0; k<nEdgesCount; k++)
+            {
+                const SIGNATURE_EDGE *pEdge=&(result.listNodes.at(nNode).listEdges.at(k));
+
+                if((pEdge->nData==nData)&&(pEdge->nMask==nMask))
                 {
-                    quint32 nCRC1=listStringCRC[i];
-                    quint32 nCRC2=listSignatureCRC[j];
+                    nNext=pEdge->nNode;
 
-                    if(nCRC1==nCRC2)
-                    {
-                        QString sTest1=pListStrings->at(i);
-                        QString sTest2=pRecords[j].pszString;
+                    break;
+                }
+            }
 
-                        SpecAbstract::_SCANS_STRUCT record= {};
-                        record.nVariant=pRecords[j].nVariant;
-                        record.filetype=pRecords[j].filetype;
-                        record.type=pRecords[j].type;
-                        record.name=pRecords[j].name;
-                        record.sVersion=pRecords[j].pszVersion;
-                        record.sInfo=pRecords[j].pszInfo;
+            if(nNext==-1)
+            {
+                SIGNATURE_EDGE edge= {};
+                edge.nData=nData;
+                edge.nMask=nMask;
+                edge.nNode=result.listNodes.count();
 
-                        record.nOffset=0;
+                result.listNodes.append(SIGNATURE_NODE());
+                result.listNodes[nNode].listEdges.append(edge);
+
+                nNext=edge.nNode;
+            }
 
-                        pMapRecords->insert(record.name,record);
+            nNode=nNext;
+        }
+
+        result.listNodes[nNode].listRecords.append(i);
+    }
+
+    return result;
+}
+
+QList<qint32> SpecAbstract::matchSignatureTable(const SpecAbstract::SIGNATURE_TABLE *pTable, const QByteArray *pbaData)
+{
+    QList<qint32> listResult;
+
+    // Every node has one parent, so a state is never active twice
+    QList<qint32> listCurrent;
+    QList<qint32> listNext;
+
+    listCurrent.append(0);
+
+    const char *pData=pbaData->constData();
+    int nDataSize=pbaData->size();
+
+    for(int i=0; (i<nDataSize)&&(!listCurrent.isEmpty()); i++)
+    {
+        quint8 nByte=(quint8)pData[i];
+
+        listNext.clear();
+
+        int nCurrentCount=listCurrent.count();
+
+        for(int j=0; j<nCurrentCount; j++)
+        {
+            const SIGNATURE_NODE *pNode=&(pTable->listNodes.at(listCurrent.at(j)));
+
+            int nEdgesCount=pNode->listEdges.count();
+
+            for(int k=0; k<nEdgesCount; k++)
+            {
+                const SIGNATURE_EDGE *pEdge=&(pNode->listEdges.at(k));
+
+                if(((nByte^pEdge->nData)&pEdge->nMask)==0)
+                {
+                    const SIGNATURE_NODE *pNextNode=&(pTable->listNodes.at(pEdge->nNode));
+
+                    listResult.append(pNextNode->listRecords);
+
+                    if(!pNextNode->listEdges.isEmpty())
+                    {
+                        listNext.append(pEdge->nNode);
                     }
                 }
             }
         }
+
+        listCurrent.swap(listNext);
     }
+
+    return listResult;
+}
+
+struct _SIGNATURE_TABLES
+{
+    QReadWriteLock lock;
+    QHash<const SpecAbstract::SIGNATURE_RECORD *,SpecAbstract::SIGNATURE_TABLE *> mapTables;
+
+    ~_SIGNATURE_TABLES()
+    {
+        qDeleteAll(mapTables);
+    }
+};
+
+Q_GLOBAL_STATIC(_SIGNATURE_TABLES,_signature_tables)
+
+const SpecAbstract::SIGNATURE_TABLE *SpecAbstract::getSignatureTable(const SpecAbstract::SIGNATURE_RECORD *pRecords, int nRecordsSize)
+{
+    _SIGNATURE_TABLES *pTables=_signature_tables();
+
+    // Compiled once; after that the scans only share a read lock
+    {
+        QReadLocker locker(&(pTables->lock));
+
+        SIGNATURE_TABLE *pResult=pTables->mapTables.value(pRecords);
+
+        if(pResult)
+        {
+            return pResult;
+        }
+    }
+
+    QWriteLocker locker(&(pTables->lock));
+
+    SIGNATURE_TABLE *pResult=pTables->mapTables.value(pRecords);
+
+    if(!pResult)
+    {
+        pResult=new SIGNATURE_TABLE(compileSignatureTable(pRecords,nRecordsSize));
+        pTables->mapTables.insert(pRecords,pResult);
+    }
+
+    return pResult;
+}
+
+SpecAbstract::STRING_TABLE SpecAbstract::compileStringTable(const SpecAbstract::STRING_RECORD *pRecords, int nRecordsSize)
+{
+    STRING_TABLE result;
+
+    int nSignaturesCount=nRecordsSize/sizeof(STRING_RECORD);
+
+    for(int i=0; i<nSignaturesCount; i++)
+    {
+        XBinary::STRING_VIEW view= {};
+        view.pData=pRecords[i].pszString;
+        view.nSize=(qint32)strlen(pRecords[i].pszString);
+
+        result.mapIndexes[view].append(i);
+    }
+
+    return result;
+}
+
+struct _STRING_TABLES
+{
+    QReadWriteLock lock;
+    QHash<const SpecAbstract::STRING_RECORD *,SpecAbstract::STRING_TABLE *> mapTables;
+
+    ~_STRING_TABLES()
+    {
+        qDeleteAll(mapTables);
+    }
+};
+
+Q_GLOBAL_STATIC(_STRING_TABLES,_string_tables)
+
+const SpecAbstract::STRING_TABLE *SpecAbstract::getStringTable(const SpecAbstract::STRING_RECORD *pRecords, int nRecordsSize)
+{
+    _STRING_TABLES *pTables=_string_tables();
+
+    // Compiled once; after that the scans only share a read lock
+    {
+        QReadLocker locker(&(pTables->lock));
+
+        STRING_TABLE *pResult=pTables->mapTables.value(pRecords);
+
+        if(pResult)
+        {
+            return pResult;
+        }
+    }
+
+    QWriteLocker locker(&(pTables->lock));
+
+    STRING_TABLE *pResult=pTables->mapTables.value(pRecords);
+
+    if(!pResult)
+    {
+        pResult=new STRING_TABLE(compileStringTable(pRecords,nRecordsSize));
+        pTables->mapTables.insert(pRecords,pResult);
+    }
+
+    return pResult;
+}
+
+void SpecAbstract::SIGNATURE_LITERAL::invalidSignatureLiteral()
+{
+    // Only reached at runtime on compilers without C++14 constexpr
 }
 
 QByteArray SpecAbstract::serializeScanStruct(SCAN_STRUCT ssRecord, bool bIsHeader)
 {
     QByteArray baResult;
 
-    QDataStream ds(baResult);
+    QDataStream ds(&baResult,QIODevice::WriteOnly);
 
     ds << ssRecord.nSize;
     ds << ssRecord.nOffset;
-    ds << ssRecord.id.uuid;
+    ds << ssRecord.id.nId;
     ds << (quint32)ssRecord.id.filetype;
     ds << (quint32)ssRecord.id.filepart;
-    ds << ssRecord.parentId.uuid;
+    ds << ssRecord.id.sInfo;
+    ds << ssRecord.id.bVirtual;
+    ds << ssRecord.parentId.nId;
     ds << (quint32)ssRecord.parentId.filetype;
     ds << (quint32)ssRecord.parentId.filepart;
+    ds << ssRecord.parentId.sInfo;
+    ds << ssRecord.parentId.bVirtual;
     ds << (quint32)ssRecord.type;
     ds << (quint32)ssRecord.name;
     ds << ssRecord.sVersion;
@@ -10645,32 +11533,44 @@ SpecAbstract::SCAN_STRUCT SpecAbstract::deserializeScanStruct(QByteArray baData,
 
     ds >> ssResult.nSize;
     ds >> ssResult.nOffset;
-    ds >> ssResult.id.uuid;
+    ds >> ssResult.id.nId;
     ds >> nTemp;
     ssResult.id.filetype=(RECORD_FILETYPE)nTemp;
     ds >> nTemp;
     ssResult.id.filepart=(RECORD_FILEPART)nTemp;
-    ds >> ssResult.parentId.uuid;
+    ds >> ssResult.id.sInfo;
+    ds >> ssResult.id.bVirtual;
+    ds >> ssResult.parentId.nId;
     ds >> nTemp;
     ssResult.parentId.filetype=(RECORD_FILETYPE)nTemp;
     ds >> nTemp;
     ssResult.parentId.filepart=(RECORD_FILEPART)nTemp;
+    ds >> ssResult.parentId.sInfo;
+    ds >> ssResult.parentId.bVirtual;
     ds >> nTemp;
     ssResult.type=(RECORD_TYPE)nTemp;
     ds >> nTemp;
     ssResult.name=(RECORD_NAME)nTemp;
     ds >> ssResult.sVersion;
     ds >> ssResult.sInfo;
-    ds >> *pbIsHeader;
+
+    bool bIsHeader=false;
+    ds >> bIsHeader;
+
+    if(pbIsHeader)
+    {
+        *pbIsHeader=bIsHeader;
+    }
 
     return ssResult;
 }
 
-QList<SpecAbstract::VCL_STRUCT> SpecAbstract::PE_getVCLstruct(QIODevice *pDevice,bool bIsImage,qint64 nOffset,qint64 nSize,bool bIs64)
+QList<SpecAbstract::VCL_STRUCT> SpecAbstract::PE_getVCLstruct(QIODevice *pDevice,bool bIsImage,const XPE::MODEL *pModel,qint64 nOffset,qint64 nSize,bool bIs64)
 {
     QList<VCL_STRUCT> listResult;
 
     XPE pe(pDevice,bIsImage);
+    pe.setModel(pModel);
 
     qint64 _nOffset=nOffset;
     qint64 _nSize=nSize;
@@ -10719,11 +11619,12 @@ QList<SpecAbstract::VCL_STRUCT> SpecAbstract::PE_getVCLstruct(QIODevice *pDevice
     return listResult;
 }
 
-SpecAbstract::VCL_PACKAGEINFO SpecAbstract::PE_getVCLPackageInfo(QIODevice *pDevice,bool bIsImage, QList<XPE::RESOURCE_RECORD> *pListResources)
+SpecAbstract::VCL_PACKAGEINFO SpecAbstract::PE_getVCLPackageInfo(QIODevice *pDevice,bool bIsImage,const XPE::MODEL *pModel,QList<XPE::RESOURCE_RECORD> *pListResources)
 {
     VCL_PACKAGEINFO result= {};
 
     XPE pe(pDevice,bIsImage);
+    pe.setModel(pModel);
 
     if(pe.isValid())
     {
@@ -10784,6 +11685,7 @@ SpecAbstract::_SCANS_STRUCT SpecAbstract::PE_getRichSignatureDescription(QIODevi
     SpecAbstract::_SCANS_STRUCT result= {};
 
     XPE pe(pDevice,bIsImage);
+    pe.setModel(&pPEInfo->peModel);
 
     if(pe.isValid())
     {
@@ -25,11 +25,31 @@
 #include <QSet>
 #include <QDataStream>
 #include <QElapsedTimer>
-#include <QUuid>
+#include <QThreadStorage>
+#include <QHash>
+#include <QVector>
+#include <QtAlgorithms>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QJsonObject>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QAtomicInt>
+#include <QSharedPointer>
 #include "xpe.h"
 #include "xelf.h"
 #include "xmach.h"
 #include "xzip.h"
+#include "cachedevice.h"
+
+// Signature literals are parsed at compile time if the compiler has C++14 constexpr
+#if (defined(__cpp_constexpr)&&(__cpp_constexpr>=201304))||(defined(_MSC_VER)&&(_MSC_VER>=1910))
+#define SPECABSTRACT_CONSTEXPR constexpr
+#else
+#define SPECABSTRACT_CONSTEXPR
+#endif
+
+#define SPECABSTRACT_SIGNATURE_MAXSIZE 150
 
 class SpecAbstract : public QObject
 {
@@ -377,9 +397,128 @@ public:
         RECORD_NAME_ZPROTECT
     };
 
+    static const qint32 RECORD_NAME_COUNT=RECORD_NAME_ZPROTECT+1; // Keep on the last name
+
+    // Used like QMap<RECORD_NAME,T>. A bit per name tells whether it is present, and the values are packed
+    // in name order, so the index of a value is the number of bits below its name and values() keeps the QMap order
+    template<class T>
+    class DETECTSET
+    {
+    public:
+        DETECTSET()
+        {
+            clear();
+        }
+
+        bool contains(RECORD_NAME name) const
+        {
+            return (name>=0)&&(name<RECORD_NAME_COUNT)&&(nBits[name/64]&((quint64)1<<(name%64)));
+        }
+
+        T value(RECORD_NAME name) const
+        {
+            T result=T();
+
+            if(contains(name))
+            {
+                result=listValues.at(_getIndex(name));
+            }
+
+            return result;
+        }
+
+        void insert(RECORD_NAME name,const T &value)
+        {
+            if(contains(name))
+            {
+                listValues[_getIndex(name)]=value;
+            }
+            else if((name>=0)&&(name<RECORD_NAME_COUNT))
+            {
+                listValues.insert(_getIndex(name),value);
+                nBits[name/64]|=((quint64)1<<(name%64));
+            }
+        }
+
+        int remove(RECORD_NAME name)
+        {
+            int nResult=0;
+
+            if(contains(name))
+            {
+                listValues.remove(_getIndex(name));
+                nBits[name/64]&=~((quint64)1<<(name%64));
+                nResult=1;
+            }
+
+            return nResult;
+        }
+
+        T &operator[](RECORD_NAME name)
+        {
+            if(!contains(name))
+            {
+                insert(name,T());
+            }
+
+            return listValues[_getIndex(name)];
+        }
+
+        int count() const
+        {
+            return listValues.count();
+        }
+
+        bool isEmpty() const
+        {
+            return listValues.isEmpty();
+        }
+
+        void clear()
+        {
+            for(int i=0; i<(int)(sizeof(nBits)/sizeof(nBits[0])); i++)
+            {
+                nBits[i]=0;
+            }
+
+            listValues.clear();
+        }
+
+        QList<T> values() const
+        {
+            return listValues.toList();
+        }
+
+        bool isSharedWith(const DETECTSET<T> &other) const // A copy nobody wrote to
+        {
+            return (memcmp(nBits,other.nBits,sizeof(nBits))==0)&&listValues.isSharedWith(other.listValues);
+        }
+
+    private:
+        int _getIndex(RECORD_NAME name) const
+        {
+            int nResult=0;
+
+            for(int i=0; i<name/64; i++)
+            {
+                nResult+=qPopulationCount(nBits[i]);
+            }
+
+            if(name%64)
+            {
+                nResult+=qPopulationCount(nBits[name/64]&(((quint64)1<<(name%64))-1));
+            }
+
+            return nResult;
+        }
+
+        quint64 nBits[(RECORD_NAME_COUNT+63)/64];
+        QVector<T> listValues;
+    };
+
     struct ID
     {
-        QUuid uuid;
+        quint32 nId; // sequential within one scan, 0 is the scanned file itself
         RECORD_FILETYPE filetype;
         RECORD_FILEPART filepart;
         QString sInfo;
@@ -402,6 +541,8 @@ public:
     struct SCAN_RESULT
     {
         qint64 nScanTime;
+        qint64 nCacheHits;      // CacheDevice page reads, for devices which are not in memory
+        qint64 nCacheMisses;
         QString sFileName;
         QList<SCAN_STRUCT> listRecords;
     };
@@ -438,8 +579,9 @@ public:
         ID id;
         qint64 nOffset;
         qint64 nSize;
+        QByteArray baHeader;
         QString sHeaderSignature;
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapHeaderDetects;
+        DETECTSET<_SCANS_STRUCT> mapHeaderDetects;
         QList<SpecAbstract::SCAN_STRUCT> listDetects;
         bool bIsDeepScan;
         bool bIsUnknown;
@@ -457,38 +599,55 @@ public:
         bool bIsZip;
         QList<XArchive::RECORD> listArchiveRecords;
 
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapTextHeaderDetects;
+        DETECTSET<_SCANS_STRUCT> mapTextHeaderDetects;
 
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultTexts;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultTools;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultArchives;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultCertificates;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultDebugData;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultInstallerData;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultSFXData;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultFormats;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultDatabases;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultImages;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultProtectorData;
+        DETECTSET<SCAN_STRUCT> mapResultTexts;
+        DETECTSET<SCAN_STRUCT> mapResultTools;
+        DETECTSET<SCAN_STRUCT> mapResultArchives;
+        DETECTSET<SCAN_STRUCT> mapResultCertificates;
+        DETECTSET<SCAN_STRUCT> mapResultDebugData;
+        DETECTSET<SCAN_STRUCT> mapResultInstallerData;
+        DETECTSET<SCAN_STRUCT> mapResultSFXData;
+        DETECTSET<SCAN_STRUCT> mapResultFormats;
+        DETECTSET<SCAN_STRUCT> mapResultDatabases;
+        DETECTSET<SCAN_STRUCT> mapResultImages;
+        DETECTSET<SCAN_STRUCT> mapResultProtectorData;
 
         QList<SpecAbstract::SCAN_STRUCT> listRecursiveDetects;
     };
 
+    struct REGION_PROBE_RESULT
+    {
+        QMutex mutex;
+        bool bIsSearched;
+        QList<qint64> listOffsets;
+    };
+
+    struct REGION_PROBE
+    {
+        qint64 nOffset;
+        qint64 nSize;
+        QList<QByteArray> listArrays;
+        QSharedPointer<REGION_PROBE_RESULT> pResult; // Shared by the copies of the info struct: one search per file
+    };
+
     struct MSDOSINFO_STRUCT
     {
         BASIC_INFO basic_info;
+        QByteArray baEntryPoint;
+        QByteArray baOverlay;
         QString sEntryPointSignature;
         QString sOverlaySignature;
         qint64 nOverlayOffset;
         qint64 nOverlaySize;
 
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapEntryPointDetects;
+        DETECTSET<_SCANS_STRUCT> mapEntryPointDetects;
 
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultDosExtenders;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultLinkers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultCompilers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultProtectors;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultPackers;
+        DETECTSET<SCAN_STRUCT> mapResultDosExtenders;
+        DETECTSET<SCAN_STRUCT> mapResultLinkers;
+        DETECTSET<SCAN_STRUCT> mapResultCompilers;
+        DETECTSET<SCAN_STRUCT> mapResultProtectors;
+        DETECTSET<SCAN_STRUCT> mapResultPackers;
 
         QList<SpecAbstract::SCAN_STRUCT> listRecursiveDetects;
     };
@@ -514,10 +673,10 @@ public:
 
         XBinary::OFFSETSIZE osCommentSection;
 
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapEntryPointDetects;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultCompilers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultLibraries;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultPackers;
+        DETECTSET<_SCANS_STRUCT> mapEntryPointDetects;
+        DETECTSET<SCAN_STRUCT> mapResultCompilers;
+        DETECTSET<SCAN_STRUCT> mapResultLibraries;
+        DETECTSET<SCAN_STRUCT> mapResultPackers;
     };
 
     struct MACHINFO_STRUCT
@@ -531,15 +690,18 @@ public:
         QList<XMACH::LIBRARY_RECORD> listLibraryRecords;
         QList<XMACH::SECTION_RECORD> listSectionRecords;
 
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapEntryPointDetects;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultCompilers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultLibraries;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultProtectors;
+        DETECTSET<_SCANS_STRUCT> mapEntryPointDetects;
+        DETECTSET<SCAN_STRUCT> mapResultCompilers;
+        DETECTSET<SCAN_STRUCT> mapResultLibraries;
+        DETECTSET<SCAN_STRUCT> mapResultProtectors;
     };
 
     struct PEINFO_STRUCT
     {
         BASIC_INFO basic_info;
+        XPE::MODEL peModel;
+        QByteArray baEntryPoint;
+        QByteArray baOverlay;
         QString sEntryPointSignature;
         QString sOverlaySignature;
         qint64 nOverlayOffset;
@@ -562,11 +724,11 @@ public:
 
         XPE::CLI_INFO cliInfo;
 
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapOverlayDetects;
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapEntryPointDetects;
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapImportDetects;
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapDotAnsistringsDetects;
-        QMap<RECORD_NAME,_SCANS_STRUCT> mapDotUnicodestringsDetects;
+        DETECTSET<_SCANS_STRUCT> mapOverlayDetects;
+        DETECTSET<_SCANS_STRUCT> mapEntryPointDetects;
+        DETECTSET<_SCANS_STRUCT> mapImportDetects;
+        DETECTSET<_SCANS_STRUCT> mapDotAnsistringsDetects;
+        DETECTSET<_SCANS_STRUCT> mapDotUnicodestringsDetects;
 
         qint32 nEntryPointSection;
         qint32 nResourceSection;
@@ -594,21 +756,50 @@ public:
         XBinary::OFFSETSIZE osConstDataSection;
         XBinary::OFFSETSIZE osImportSection;
 
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultLinkers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultCompilers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultLibraries;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultTools;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultSigntools;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultProtectors;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultPackers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultInstallers;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultSFX;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultNETObfuscators;
-        QMap<RECORD_NAME,SCAN_STRUCT> mapResultDongleProtection;
+        REGION_PROBE probeCodeSection;
+        REGION_PROBE probeDataSection;
+        REGION_PROBE probeOverlay;
+
+        DETECTSET<SCAN_STRUCT> mapResultLinkers;
+        DETECTSET<SCAN_STRUCT> mapResultCompilers;
+        DETECTSET<SCAN_STRUCT> mapResultLibraries;
+        DETECTSET<SCAN_STRUCT> mapResultTools;
+        DETECTSET<SCAN_STRUCT> mapResultSigntools;
+        DETECTSET<SCAN_STRUCT> mapResultProtectors;
+        DETECTSET<SCAN_STRUCT> mapResultPackers;
+        DETECTSET<SCAN_STRUCT> mapResultInstallers;
+        DETECTSET<SCAN_STRUCT> mapResultSFX;
+        DETECTSET<SCAN_STRUCT> mapResultNETObfuscators;
+        DETECTSET<SCAN_STRUCT> mapResultDongleProtection;
 
         QList<SpecAbstract::SCAN_STRUCT> listRecursiveDetects;
     };
 
+    enum PE_RESULTMAP
+    {
+        PE_RESULTMAP_IMPORTDETECTS=0x0001,
+        PE_RESULTMAP_LINKERS=0x0002,
+        PE_RESULTMAP_COMPILERS=0x0004,
+        PE_RESULTMAP_LIBRARIES=0x0008,
+        PE_RESULTMAP_TOOLS=0x0010,
+        PE_RESULTMAP_SIGNTOOLS=0x0020,
+        PE_RESULTMAP_PROTECTORS=0x0040,
+        PE_RESULTMAP_PACKERS=0x0080,
+        PE_RESULTMAP_INSTALLERS=0x0100,
+        PE_RESULTMAP_SFX=0x0200,
+        PE_RESULTMAP_NETOBFUSCATORS=0x0400,
+        PE_RESULTMAP_DONGLEPROTECTION=0x0800
+    };
+
+    typedef void (*PE_HANDLER)(QIODevice *pDevice,bool bIsImage,PEINFO_STRUCT *pPEInfo);
+
+    struct PE_HANDLER_RECORD
+    {
+        PE_HANDLER pHandler;
+        quint32 nReads;     // PE_RESULTMAP flags the handler looks at
+        quint32 nWrites;    // PE_RESULTMAP flags the handler inserts into or removes from
+    };
+
     struct SCAN_OPTIONS
     {
         //        bool bEmulate;
@@ -617,6 +808,11 @@ public:
         bool bResultAsXML;
         bool bSubdirectories;
         bool bIsImage;
+        qint32 nThreads; // Directory scan; 0 - QThread::idealThreadCount()
+        bool bOrderedResults; // Directory scan; emit results in the order of the file list
+        bool bParallelDetects; // PE: run independent handlers of one file concurrently; only for devices in memory
+        bool bDeduplicate; // Directory scan; byte-identical files are scanned once
+        bool bMapFiles; // StaticScan reads files through QFile::map; a file truncated during the scan raises SIGBUS
     };
 
     struct UNPACK_OPTIONS
@@ -625,6 +821,88 @@ public:
         bool bCopyOverlay;     // In
     };
 
+    struct SIGNATURE_LITERAL
+    {
+        const char *pszString;
+        quint8 nData[SPECABSTRACT_SIGNATURE_MAXSIZE];
+        quint8 nMask[SPECABSTRACT_SIGNATURE_MAXSIZE];
+        qint32 nSize;
+        bool bIsValid;
+
+        // Same syntax as XBinary::convertSignature: hex nibbles, '.' or '?' wildcards, 'ansi' text
+        template<int N>
+        SPECABSTRACT_CONSTEXPR SIGNATURE_LITERAL(const char (&pszSignature)[N]) : pszString(pszSignature),nData(),nMask(),nSize(0),bIsValid(true)
+        {
+            bool bAnsiString=false;
+            qint32 nNibbles=0;
+
+            for(int i=0; (i<N-1)&&(bIsValid); i++)
+            {
+                char c=pszSignature[i];
+
+                if(c=='\'')
+                {
+                    bAnsiString=!bAnsiString;
+                }
+                else if(bAnsiString)
+                {
+                    nNibbles=_addNibble(nNibbles,((quint8)c)>>4,0xF);
+                    nNibbles=_addNibble(nNibbles,((quint8)c)&0xF,0xF);
+                }
+                else if((c>='0')&&(c<='9'))
+                {
+                    nNibbles=_addNibble(nNibbles,c-'0',0xF);
+                }
+                else if((c>='a')&&(c<='f'))
+                {
+                    nNibbles=_addNibble(nNibbles,c-'a'+10,0xF);
+                }
+                else if((c>='A')&&(c<='F'))
+                {
+                    nNibbles=_addNibble(nNibbles,c-'A'+10,0xF);
+                }
+                else if((c=='.')||(c=='?'))
+                {
+                    nNibbles=_addNibble(nNibbles,0,0);
+                }
+                else if(c!=' ')
+                {
+                    invalidSignatureLiteral(); // Invalid character
+                    bIsValid=false;
+                }
+            }
+
+            if(bAnsiString||(nNibbles&1))
+            {
+                invalidSignatureLiteral(); // Unterminated string or odd number of nibbles
+                bIsValid=false;
+            }
+
+            nSize=bIsValid?(nNibbles/2):0;
+        }
+
+        SPECABSTRACT_CONSTEXPR qint32 _addNibble(qint32 nNibbles,quint8 nValue,quint8 nValueMask)
+        {
+            if(nNibbles>=2*SPECABSTRACT_SIGNATURE_MAXSIZE)
+            {
+                invalidSignatureLiteral(); // Too long
+                bIsValid=false;
+
+                return nNibbles;
+            }
+
+            int nShift=(nNibbles&1)?0:4;
+
+            nData[nNibbles/2]|=(quint8)(nValue<<nShift);
+            nMask[nNibbles/2]|=(quint8)(nValueMask<<nShift);
+
+            return nNibbles+1;
+        }
+
+        // Not constexpr: a malformed literal in a constexpr table is a compile error
+        static void invalidSignatureLiteral();
+    };
+
     struct SIGNATURE_RECORD
     {
         quint32 nVariant;
@@ -633,7 +911,26 @@ public:
         const RECORD_NAME name;
         const char *pszVersion;
         const char *pszInfo;
-        const char *pszSignature;
+        SIGNATURE_LITERAL signature;
+    };
+
+    struct SIGNATURE_EDGE
+    {
+        quint8 nData;
+        quint8 nMask;
+        qint32 nNode;
+    };
+
+    struct SIGNATURE_NODE
+    {
+        QList<SIGNATURE_EDGE> listEdges;
+        QList<qint32> listRecords;
+    };
+
+    struct SIGNATURE_TABLE
+    {
+        QList<SIGNATURE_NODE> listNodes; // anchored trie, node 0 is the root
+        QList<qint32> listUncompiled;
     };
 
     struct STRING_RECORD
@@ -647,6 +944,11 @@ public:
         const char *pszString;
     };
 
+    struct STRING_TABLE
+    {
+        QHash<XBinary::STRING_VIEW,QList<qint32> > mapIndexes; // the records of a string, in table order; the keys point to the records
+    };
+
     struct SCANMEMORY_RECORD
     {
         quint32 nVariant;
@@ -720,7 +1022,9 @@ public:
     static QString createFullResultString(const SCAN_STRUCT *pScanStruct);
     static QString createFullResultString2(const SCAN_STRUCT *pScanStruct);
     static QString createTypeString(const SCAN_STRUCT *pScanStruct);
+    static QJsonObject createJsonObject(const SCAN_STRUCT *pScanStruct);
     static SCAN_STRUCT createHeaderScanStruct(const SCAN_STRUCT *pScanStruct);
+    static quint32 createId();
 
     static QString findEnigmaVersion(QIODevice *pDevice,bool bIsImage,qint64 nOffset,qint64 nSize);
 
@@ -731,6 +1035,7 @@ public:
     static PEINFO_STRUCT getPEInfo(QIODevice *pDevice,SpecAbstract::ID parentId,SpecAbstract::SCAN_OPTIONS *pOptions,qint64 nOffset);
 
     static _SCANS_STRUCT getScansStruct(quint32 nVariant,RECORD_FILETYPE filetype,RECORD_TYPE type,RECORD_NAME name,QString sVersion,QString sInfo,qint64 nOffset);
+    static _SCANS_STRUCT getScansStruct(quint32 nVariant,RECORD_FILETYPE filetype,RECORD_TYPE type,RECORD_NAME name,const char *pszVersion,const char *pszInfo,qint64 nOffset);
 
     static void PE_handle_import(QIODevice *pDevice,bool bIsImage,PEINFO_STRUCT *pPEInfo);
     static void PE_handle_Protection(QIODevice *pDevice,bool bIsImage,PEINFO_STRUCT *pPEInfo);
@@ -757,6 +1062,10 @@ public:
 
     static void PE_handle_Recursive(QIODevice *pDevice,bool bIsImage,PEINFO_STRUCT *pPEInfo,SpecAbstract::SCAN_OPTIONS *pOptions);
 
+    static QList<PE_HANDLER_RECORD> PE_getHandlers();
+    static void PE_copyResults(PEINFO_STRUCT *pDest,const PEINFO_STRUCT *pSource,quint32 nMaps);
+    static void PE_runHandlers(QIODevice *pDevice,bool bIsImage,PEINFO_STRUCT *pPEInfo,bool bParallel);
+
     static void Binary_handle_Texts(QIODevice *pDevice,bool bIsImage,BINARYINFO_STRUCT *pBinaryInfo);
     static void Binary_handle_Archives(QIODevice *pDevice,bool bIsImage,BINARYINFO_STRUCT *pBinaryInfo);
     static void Binary_handle_Certificates(QIODevice *pDevice,bool bIsImage,BINARYINFO_STRUCT *pBinaryInfo);
@@ -786,9 +1095,9 @@ public:
     static void MACH_handle_Tools(QIODevice *pDevice,bool bIsImage, MACHINFO_STRUCT *pMACHInfo);
     static void MACH_handle_Protection(QIODevice *pDevice,bool bIsImage, MACHINFO_STRUCT *pMACHInfo);
 
-    static void updateVersion(QMap<RECORD_NAME,SCAN_STRUCT> *map,RECORD_NAME name,QString sVersion);
-    static void updateInfo(QMap<RECORD_NAME,SCAN_STRUCT> *map,RECORD_NAME name,QString sInfo);
-    static void updateVersionAndInfo(QMap<RECORD_NAME,SCAN_STRUCT> *map,RECORD_NAME name,QString sVersion,QString sInfo);
+    static void updateVersion(DETECTSET<SCAN_STRUCT> *map,RECORD_NAME name,QString sVersion);
+    static void updateInfo(DETECTSET<SCAN_STRUCT> *map,RECORD_NAME name,QString sInfo);
+    static void updateVersionAndInfo(DETECTSET<SCAN_STRUCT> *map,RECORD_NAME name,QString sVersion,QString sInfo);
 
     static bool isScanStructPresent(QList<SpecAbstract::SCAN_STRUCT> *pList,RECORD_FILETYPE filetype,RECORD_TYPE type,RECORD_NAME name,QString sVersion,QString sInfo);
 
@@ -800,11 +1109,11 @@ public:
 
     static bool PE_isValid_UPX(QIODevice *pDevice,bool bIsImage,PEINFO_STRUCT *pPEInfo);
 
-    static QList<VCL_STRUCT> PE_getVCLstruct(QIODevice *pDevice,bool bIsImage,qint64 nOffset,qint64 nSize,bool bIs64);
-    static VCL_PACKAGEINFO PE_getVCLPackageInfo(QIODevice *pDevice,bool bIsImage,QList<XPE::RESOURCE_RECORD> *pListResources);
+    static QList<VCL_STRUCT> PE_getVCLstruct(QIODevice *pDevice,bool bIsImage,const XPE::MODEL *pModel,qint64 nOffset,qint64 nSize,bool bIs64);
+    static VCL_PACKAGEINFO PE_getVCLPackageInfo(QIODevice *pDevice,bool bIsImage,const XPE::MODEL *pModel,QList<XPE::RESOURCE_RECORD> *pListResources);
     static SpecAbstract::_SCANS_STRUCT PE_getRichSignatureDescription(QIODevice *pDevice,bool bIsImage,PEINFO_STRUCT *pPEInfo,quint32 nRichID);
 
-    static QList<SCAN_STRUCT> mapToList(QMap<RECORD_NAME,SCAN_STRUCT> *pMapRecords);
+    static QList<SCAN_STRUCT> mapToList(DETECTSET<SCAN_STRUCT> *pMapRecords);
     //    static SCAN_STRUCT getScanStruct(QMap<RECORD_NAMES,SCANS_STRUCT> *pMapDetects,BASIC_INFO *pBasicInfo,RECORD_NAMES recordName);
 
     static SCAN_STRUCT scansToScan(BASIC_INFO *pBasicInfo,_SCANS_STRUCT *pScansStruct);
@@ -812,10 +1121,20 @@ public:
     static QByteArray _BasicPEInfoToArray(BASIC_PE_INFO *pInfo);
     static BASIC_PE_INFO _ArrayToBasicPEInfo(const QByteArray *pbaArray);
 
-    static void memoryScan(QMap<RECORD_NAME,_SCANS_STRUCT> *pMapRecords,QIODevice *pDevice,bool bIsImage,qint64 nOffset,qint64 nSize,SpecAbstract::SCANMEMORY_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2);
-    static void signatureScan(QMap<RECORD_NAME,_SCANS_STRUCT> *pMapRecords,QString sSignature,SIGNATURE_RECORD *pRecords,int nRecordsSize,RECORD_FILETYPE fileType1,RECORD_FILETYPE fileType2);
-    static void resourcesScan(QMap<RECORD_NAME,_SCANS_STRUCT> *pMapRecords,QList<XPE::RESOURCE_RECORD> *pListResources,RESOURCES_RECORD *pRecords,int nRecordsSize,RECORD_FILETYPE fileType1,RECORD_FILETYPE fileType2);
-    static void stringScan(QMap<RECORD_NAME,_SCANS_STRUCT> *pMapRecords,QList<QString> *pListStrings,STRING_RECORD *pRecords,int nRecordsSize,RECORD_FILETYPE fileType1,RECORD_FILETYPE fileType2);
+    static void memoryScan(DETECTSET<_SCANS_STRUCT> *pMapRecords,QIODevice *pDevice,bool bIsImage,qint64 nOffset,qint64 nSize,SpecAbstract::SCANMEMORY_RECORD *pRecords, int nRecordsSize, SpecAbstract::RECORD_FILETYPE fileType1, SpecAbstract::RECORD_FILETYPE fileType2);
+    static void signatureScan(DETECTSET<_SCANS_STRUCT> *pMapRecords,const QByteArray *pbaData,const SIGNATURE_RECORD *pRecords,int nRecordsSize,RECORD_FILETYPE fileType1,RECORD_FILETYPE fileType2);
+    static void resourcesScan(DETECTSET<_SCANS_STRUCT> *pMapRecords,QList<XPE::RESOURCE_RECORD> *pListResources,RESOURCES_RECORD *pRecords,int nRecordsSize,RECORD_FILETYPE fileType1,RECORD_FILETYPE fileType2);
+    static void stringScan(DETECTSET<_SCANS_STRUCT> *pMapRecords,const QVector<XBinary::STRING_VIEW> *pListStrings,STRING_RECORD *pRecords,int nRecordsSize,RECORD_FILETYPE fileType1,RECORD_FILETYPE fileType2);
+
+    static REGION_PROBE createRegionProbe(qint64 nOffset,qint64 nSize,const char **ppszStrings,int nStringsSize);
+    static qint64 findRegionProbe(XBinary *pBinary,REGION_PROBE *pProbe,const char *pszString);
+
+    static SIGNATURE_TABLE compileSignatureTable(const SIGNATURE_RECORD *pRecords,int nRecordsSize);
+    static const SIGNATURE_TABLE *getSignatureTable(const SIGNATURE_RECORD *pRecords,int nRecordsSize);
+    static QString getPoolString(const char *pszString); // one shared QString per distinct static string
+    static STRING_TABLE compileStringTable(const STRING_RECORD *pRecords,int nRecordsSize);
+    static const STRING_TABLE *getStringTable(const STRING_RECORD *pRecords,int nRecordsSize);
+    static QList<qint32> matchSignatureTable(const SIGNATURE_TABLE *pTable,const QByteArray *pbaData);
 
     static QByteArray serializeScanStruct(SCAN_STRUCT ssRecord,bool bIsHeader=false);
     static SCAN_STRUCT deserializeScanStruct(QByteArray baData,bool *pbIsHeader=nullptr);
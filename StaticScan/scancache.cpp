@@ -0,0 +1,307 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "scancache.h"
+#include "staticscan.h"
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+ScanCache::ScanCache(QObject *parent) : QObject(parent)
+{
+    bHashContent=false;
+    bIsModified=false;
+}
+
+bool ScanCache::open(QString sFileName, bool bHashContent)
+{
+    QMutexLocker locker(&mutex);
+
+    this->sFileName=sFileName;
+    this->bHashContent=bHashContent;
+    this->bIsModified=false;
+
+    mapRecords.clear();
+
+    bool bResult=false;
+
+    QFile file;
+    file.setFileName(sFileName);
+
+    if(file.open(QIODevice::ReadOnly))
+    {
+        QDataStream ds(&file);
+
+        quint32 nMagic=0;
+        quint32 nFormatVersion=0;
+        quint32 nNumberOfRecords=0;
+
+        ds >> nMagic;
+        ds >> nFormatVersion;
+        ds >> nNumberOfRecords;
+
+        if((nMagic==SSC_MAGIC)&&(nFormatVersion==SSC_FORMATVERSION))
+        {
+            QString sEngineVersion=StaticScan::getEngineVersion();
+            qint64 nCurrentTime=QDateTime::currentMSecsSinceEpoch();
+
+            for(quint32 i=0;(i<nNumberOfRecords)&&(ds.status()==QDataStream::Ok);i++)
+            {
+                QByteArray baKey;
+                RECORD record= {};
+                quint32 nNumberOfScans=0;
+
+                ds >> baKey;
+                ds >> record.sEngineVersion;
+                ds >> record.nOptionsFlags;
+                ds >> record.nLastUse;
+                ds >> nNumberOfScans;
+
+                for(quint32 j=0;(j<nNumberOfScans)&&(ds.status()==QDataStream::Ok);j++)
+                {
+                    QByteArray baScan;
+                    ds >> baScan;
+
+                    record.listRecords.append(SpecAbstract::deserializeScanStruct(baScan));
+                }
+
+                if(ds.status()==QDataStream::Ok)
+                {
+                    // Results of other engine versions and old results would never be used again
+                    if((record.sEngineVersion==sEngineVersion)&&(nCurrentTime-record.nLastUse<=SSC_MAXAGE))
+                    {
+                        mapRecords.insert(baKey,record);
+                    }
+                    else
+                    {
+                        bIsModified=true;
+                    }
+                }
+            }
+
+            bResult=(ds.status()==QDataStream::Ok);
+        }
+
+        file.close();
+    }
+
+    if(!bResult)
+    {
+        mapRecords.clear();
+        bIsModified=false;
+    }
+
+    return bResult;
+}
+
+bool ScanCache::save()
+{
+    QMutexLocker locker(&mutex);
+
+    bool bResult=false;
+
+    if(!bIsModified)
+    {
+        bResult=true;
+    }
+    else if(sFileName!="")
+    {
+        // QSaveFile replaces the old cache only after everything is written
+        QSaveFile file(sFileName);
+
+        if(file.open(QIODevice::WriteOnly))
+        {
+            QDataStream ds(&file);
+
+            ds << (quint32)SSC_MAGIC;
+            ds << (quint32)SSC_FORMATVERSION;
+            ds << (quint32)mapRecords.count();
+
+            QHash<QByteArray,RECORD>::const_iterator iter=mapRecords.constBegin();
+
+            while(iter!=mapRecords.constEnd())
+            {
+                ds << iter.key();
+                ds << iter.value().sEngineVersion;
+                ds << iter.value().nOptionsFlags;
+                ds << iter.value().nLastUse;
+                ds << (quint32)iter.value().listRecords.count();
+
+                for(int i=0;i<iter.value().listRecords.count();i++)
+                {
+                    ds << SpecAbstract::serializeScanStruct(iter.value().listRecords.at(i));
+                }
+
+                iter++;
+            }
+
+            if(file.commit())
+            {
+                bIsModified=false;
+                bResult=true;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+QByteArray ScanCache::getKey(QString sFileName)
+{
+    return getFileKey(sFileName,bHashContent);
+}
+
+bool ScanCache::getResult(QByteArray baKey, SpecAbstract::SCAN_OPTIONS *pOptions, SpecAbstract::SCAN_RESULT *pScanResult)
+{
+    bool bResult=false;
+
+    if(baKey.size())
+    {
+        QMutexLocker locker(&mutex);
+
+        QHash<QByteArray,RECORD>::iterator iter=mapRecords.find(baKey);
+
+        if(iter!=mapRecords.end())
+        {
+            if((iter.value().sEngineVersion==StaticScan::getEngineVersion())&&(iter.value().nOptionsFlags==getOptionsFlags(pOptions)))
+            {
+                pScanResult->listRecords=iter.value().listRecords;
+
+                qint64 nCurrentTime=QDateTime::currentMSecsSinceEpoch();
+
+                if(nCurrentTime-iter.value().nLastUse>SSC_TOUCHINTERVAL)
+                {
+                    iter.value().nLastUse=nCurrentTime;
+                    bIsModified=true;
+                }
+
+                bResult=true;
+            }
+        }
+    }
+
+    return bResult;
+}
+
+void ScanCache::setResult(QByteArray baKey, SpecAbstract::SCAN_OPTIONS *pOptions, SpecAbstract::SCAN_RESULT *pScanResult)
+{
+    // Results without records are kept too: most files have no detects. The caller skips files it could not read
+    if(baKey.size())
+    {
+        QMutexLocker locker(&mutex);
+
+        RECORD record= {};
+        record.sEngineVersion=StaticScan::getEngineVersion();
+        record.nOptionsFlags=getOptionsFlags(pOptions);
+        record.nLastUse=QDateTime::currentMSecsSinceEpoch();
+        record.listRecords=pScanResult->listRecords;
+
+        mapRecords.insert(baKey,record);
+
+        bIsModified=true;
+    }
+}
+
+QByteArray ScanCache::getFileKey(QString sFileName, bool bHashContent)
+{
+    QByteArray baResult;
+
+    QFileInfo fi(sFileName);
+
+    if(fi.isFile())
+    {
+        bool bIsValid=true;
+
+        {
+            QDataStream ds(&baResult,QIODevice::WriteOnly);
+
+#ifdef Q_OS_UNIX
+            struct stat st;
+
+            if(stat(QFile::encodeName(fi.absoluteFilePath()).constData(),&st)==0)
+            {
+                ds << (quint64)st.st_dev;
+                ds << (quint64)st.st_ino;
+            }
+            else
+            {
+                ds << fi.absoluteFilePath();
+            }
+#else
+            // No inode here, the path stands in for it
+            ds << fi.absoluteFilePath();
+#endif
+            ds << fi.size();
+            ds << fi.lastModified().toMSecsSinceEpoch();
+
+            if(bHashContent)
+            {
+                QFile file;
+                file.setFileName(sFileName);
+
+                bIsValid=false;
+
+                if(file.open(QIODevice::ReadOnly))
+                {
+                    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+                    if(hash.addData(&file))
+                    {
+                        ds << hash.result();
+
+                        bIsValid=true;
+                    }
+
+                    file.close();
+                }
+            }
+        }
+
+        if(!bIsValid)
+        {
+            baResult.clear();
+        }
+    }
+
+    return baResult;
+}
+
+quint32 ScanCache::getOptionsFlags(SpecAbstract::SCAN_OPTIONS *pOptions)
+{
+    quint32 nResult=0;
+
+    // Only the options that change the records
+    if(pOptions->bRecursive)
+    {
+        nResult|=0x01;
+    }
+
+    if(pOptions->bDeepScan)
+    {
+        nResult|=0x02;
+    }
+
+    if(pOptions->bIsImage)
+    {
+        nResult|=0x04;
+    }
+
+    return nResult;
+}
@@ -0,0 +1,70 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef SCANCACHE_H
+#define SCANCACHE_H
+
+#include <QObject>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QDateTime>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QHash>
+#include <QMutex>
+#include "specabstract.h"
+
+#define SSC_MAGIC 0x4E464443
+#define SSC_FORMATVERSION 3
+#define SSC_MAXAGE (30LL*24*60*60*1000) // Records not used for this long are dropped; the keys of changed or deleted files are never used again
+#define SSC_TOUCHINTERVAL (24LL*60*60*1000) // A hit updates the use time of a record at most this often, so runs with hits only do not rewrite the file
+
+class ScanCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ScanCache(QObject *parent=nullptr);
+
+    bool open(QString sFileName,bool bHashContent=false); // A missing or unreadable file gives an empty cache
+    bool save();
+    QByteArray getKey(QString sFileName);
+    bool getResult(QByteArray baKey,SpecAbstract::SCAN_OPTIONS *pOptions,SpecAbstract::SCAN_RESULT *pScanResult);
+    void setResult(QByteArray baKey,SpecAbstract::SCAN_OPTIONS *pOptions,SpecAbstract::SCAN_RESULT *pScanResult);
+    static QByteArray getFileKey(QString sFileName,bool bHashContent);
+    static quint32 getOptionsFlags(SpecAbstract::SCAN_OPTIONS *pOptions);
+
+private:
+    struct RECORD
+    {
+        QString sEngineVersion;
+        quint32 nOptionsFlags;
+        qint64 nLastUse; // ms since epoch
+        QList<SpecAbstract::SCAN_STRUCT> listRecords;
+    };
+
+    QString sFileName;
+    bool bHashContent;
+    bool bIsModified;
+    QHash<QByteArray,RECORD> mapRecords;
+    QMutex mutex;
+};
+
+#endif // SCANCACHE_H
@@ -0,0 +1,224 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "scandedup.h"
+
+ScanDedup::ScanDedup(qint32 nMaxRecords, QObject *parent) : QObject(parent)
+{
+    this->nMaxRecords=qMax(1,nMaxRecords);
+    nNumberOfRecords=0;
+}
+
+void ScanDedup::clear()
+{
+    QMutexLocker locker(&mutex);
+
+    mapRecords.clear();
+    queueFingerprints.clear();
+    nNumberOfRecords=0;
+    nSavedScans.storeRelease(0);
+}
+
+bool ScanDedup::getResult(QString sFileName, QByteArray *pbaFingerprint, SpecAbstract::SCAN_RESULT *pScanResult)
+{
+    bool bResult=false;
+
+    bool bIsComplete=false;
+    *pbaFingerprint=getFingerprint(sFileName,&bIsComplete);
+
+    if(pbaFingerprint->size())
+    {
+        QList<RECORD> listCandidates;
+
+        {
+            QMutexLocker locker(&mutex);
+
+            listCandidates=mapRecords.value(*pbaFingerprint);
+        }
+
+        QByteArray baContentHash;
+
+        for(int i=0;(i<listCandidates.count())&&(!bResult);i++)
+        {
+            RECORD record=listCandidates.at(i);
+
+            if(bIsComplete&&record.bIsComplete)
+            {
+                bResult=true;
+            }
+            else
+            {
+                if(record.baContentHash.isEmpty())
+                {
+                    // The earlier file is hashed now: its result describes it only if it was not changed since
+                    QFileInfo fi(record.sFileName);
+
+                    if((fi.size()!=record.nSize)||(fi.lastModified().toMSecsSinceEpoch()!=record.nModified))
+                    {
+                        continue;
+                    }
+                }
+
+                // Same size, head and tail; only a hash of both files tells them apart
+                if(baContentHash.isEmpty())
+                {
+                    baContentHash=getContentHash(sFileName);
+                }
+
+                if(record.baContentHash.isEmpty())
+                {
+                    record.baContentHash=getContentHash(record.sFileName);
+
+                    QMutexLocker locker(&mutex);
+
+                    QList<RECORD> *pListRecords=&(mapRecords[*pbaFingerprint]);
+
+                    for(int j=0;j<pListRecords->count();j++)
+                    {
+                        if((*pListRecords)[j].sFileName==record.sFileName)
+                        {
+                            (*pListRecords)[j].baContentHash=record.baContentHash;
+                        }
+                    }
+                }
+
+                bResult=(baContentHash.size()&&(baContentHash==record.baContentHash));
+            }
+
+            if(bResult)
+            {
+                pScanResult->listRecords=record.listRecords;
+
+                nSavedScans.fetchAndAddOrdered(1);
+            }
+        }
+    }
+
+    return bResult;
+}
+
+void ScanDedup::setResult(QString sFileName, QByteArray baFingerprint, SpecAbstract::SCAN_RESULT *pScanResult)
+{
+    // Results without detects are kept too: they are the most common duplicates
+    if(baFingerprint.size())
+    {
+        QFileInfo fi(sFileName);
+
+        RECORD record= {};
+        record.sFileName=sFileName;
+        record.nSize=fi.size();
+        record.nModified=fi.lastModified().toMSecsSinceEpoch();
+        record.bIsComplete=(record.nSize<=2*SSD_PARTSIZE);
+        record.listRecords=pScanResult->listRecords;
+
+        QMutexLocker locker(&mutex);
+
+        while(nNumberOfRecords>=nMaxRecords)
+        {
+            nNumberOfRecords-=mapRecords.take(queueFingerprints.dequeue()).count();
+        }
+
+        if(!mapRecords.contains(baFingerprint))
+        {
+            queueFingerprints.enqueue(baFingerprint);
+        }
+
+        mapRecords[baFingerprint].append(record);
+        nNumberOfRecords++;
+    }
+}
+
+qint32 ScanDedup::getNumberOfSavedScans()
+{
+    return nSavedScans.loadAcquire();
+}
+
+QByteArray ScanDedup::getFingerprint(QString sFileName, bool *pbIsComplete)
+{
+    QByteArray baResult;
+
+    QFile file;
+    file.setFileName(sFileName);
+
+    if(file.open(QIODevice::ReadOnly))
+    {
+        qint64 nSize=file.size();
+
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData((char *)&nSize,sizeof(nSize));
+
+        if(nSize<=2*SSD_PARTSIZE)
+        {
+            QByteArray baData=file.readAll();
+
+            if(baData.size()==nSize)
+            {
+                hash.addData(baData);
+                baResult=hash.result();
+            }
+
+            *pbIsComplete=true;
+        }
+        else
+        {
+            QByteArray baHead=file.read(SSD_PARTSIZE);
+
+            if((baHead.size()==SSD_PARTSIZE)&&file.seek(nSize-SSD_PARTSIZE))
+            {
+                QByteArray baTail=file.read(SSD_PARTSIZE);
+
+                if(baTail.size()==SSD_PARTSIZE)
+                {
+                    hash.addData(baHead);
+                    hash.addData(baTail);
+                    baResult=hash.result();
+                }
+            }
+
+            *pbIsComplete=false;
+        }
+
+        file.close();
+    }
+
+    return baResult;
+}
+
+QByteArray ScanDedup::getContentHash(QString sFileName)
+{
+    QByteArray baResult;
+
+    QFile file;
+    file.setFileName(sFileName);
+
+    if(file.open(QIODevice::ReadOnly))
+    {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+
+        if(hash.addData(&file))
+        {
+            baResult=hash.result();
+        }
+
+        file.close();
+    }
+
+    return baResult;
+}
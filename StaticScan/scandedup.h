@@ -0,0 +1,69 @@
+// copyright (c) 2017-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef SCANDEDUP_H
+#define SCANDEDUP_H
+
+#include <QObject>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+#include <QHash>
+#include <QQueue>
+#include <QMutex>
+#include <QAtomicInt>
+#include "specabstract.h"
+
+#define SSD_PARTSIZE 0x10000
+#define SSD_MAXRECORDS 16384
+
+class ScanDedup : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ScanDedup(qint32 nMaxRecords=SSD_MAXRECORDS,QObject *parent=nullptr);
+
+    void clear();
+    bool getResult(QString sFileName,QByteArray *pbaFingerprint,SpecAbstract::SCAN_RESULT *pScanResult); // pbaFingerprint is for setResult
+    void setResult(QString sFileName,QByteArray baFingerprint,SpecAbstract::SCAN_RESULT *pScanResult);
+    qint32 getNumberOfSavedScans();
+    static QByteArray getFingerprint(QString sFileName,bool *pbIsComplete); // Size, the first and the last SSD_PARTSIZE bytes
+    static QByteArray getContentHash(QString sFileName);
+
+private:
+    struct RECORD
+    {
+        QString sFileName;
+        bool bIsComplete; // The fingerprint covers the whole file
+        qint64 nSize;
+        qint64 nModified; // The file is not reused if it changed after its scan
+        QByteArray baContentHash; // Computed when another file has the same fingerprint
+        QList<SpecAbstract::SCAN_STRUCT> listRecords;
+    };
+
+    qint32 nMaxRecords;
+    qint32 nNumberOfRecords;
+    QHash<QByteArray,QList<RECORD> > mapRecords;
+    QQueue<QByteArray> queueFingerprints; // Oldest first
+    QMutex mutex;
+    QAtomicInt nSavedScans;
+};
+
+#endif // SCANDEDUP_H
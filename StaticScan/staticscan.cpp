@@ -19,14 +19,24 @@
 // SOFTWARE.
 //
 #include "staticscan.h"
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#include <errno.h>
 
 StaticScan::StaticScan(QObject *parent) : QObject(parent)
 {
     bIsStop=false;
     _pOptions=nullptr;
     _pScanResult=nullptr;
+    pScanCache=nullptr;
+    _pListDevice=nullptr;
     currentStats=STATS();
     pElapsedTimer=nullptr;
+    nNextResult.storeRelease(0);
+    bIsEnumerated=false;
 
     scanType=SCAN_TYPE_DEVICE;
 }
@@ -57,6 +67,22 @@ void StaticScan::setData(QString sFileName, SpecAbstract::SCAN_OPTIONS *pOptions
     this->scanType=SCAN_TYPE_DIRECTORY;
 }
 
+void StaticScan::setData(QList<QString> *pListFiles, SpecAbstract::SCAN_OPTIONS *pOptions)
+{
+    this->listFiles=*pListFiles;
+    this->_pOptions=pOptions;
+
+    this->scanType=SCAN_TYPE_FILES;
+}
+
+void StaticScan::setData(QIODevice *pListDevice, SpecAbstract::SCAN_OPTIONS *pOptions)
+{
+    this->_pListDevice=pListDevice;
+    this->_pOptions=pOptions;
+
+    this->scanType=SCAN_TYPE_STREAM;
+}
+
 void StaticScan::process()
 {
     pElapsedTimer=new QElapsedTimer;
@@ -64,6 +90,10 @@ void StaticScan::process()
 
     currentStats.nTotal=0;
     currentStats.nCurrent=0;
+    currentStats.nCacheHits=0;
+    currentStats.nCacheMisses=0;
+    nTotalFiles.storeRelease(0);
+    nCurrentFile.storeRelease(0);
 
     bIsStop=false;
 
@@ -71,7 +101,7 @@ void StaticScan::process()
     {
         if((_pScanResult)&&(_sFileName!=""))
         {
-            currentStats.sStatus=tr("File scan");
+            _setStatus(tr("File scan"));
 
             *_pScanResult=scanFile(_sFileName);
 
@@ -82,34 +112,31 @@ void StaticScan::process()
     {
         if(_sFileName!="")
         {
-            currentStats.sStatus=tr("Directory scan");
-            QList<QString> listFiles;
-
-            XBinary::FFOPTIONS ffoptions= {};
-            ffoptions.bSubdirectories=_pOptions->bSubdirectories;
-            ffoptions.pbIsStop=&bIsStop;
-            ffoptions.pnNumberOfFiles=&(currentStats.nTotal);
-            ffoptions.pListFiles=&listFiles;
+            _setStatus(tr("Directory scan"));
 
-            XBinary::findFiles(_sFileName,&ffoptions);
-
-            currentStats.nTotal=listFiles.count();
+            _processFiles();
+        }
+    }
+    else if(this->scanType==SCAN_TYPE_FILES)
+    {
+        _setStatus(tr("Files scan"));
 
-            for(int i=0; (i<currentStats.nTotal)&&(!bIsStop); i++)
-            {
-                currentStats.nCurrent=i+1;
-                currentStats.sStatus=listFiles.at(i);
-                SpecAbstract::SCAN_RESULT _scanResult=scanFile(currentStats.sStatus);
+        _processFiles();
+    }
+    else if(this->scanType==SCAN_TYPE_STREAM)
+    {
+        if(_pListDevice)
+        {
+            _setStatus(tr("Files scan"));
 
-                emit scanResult(_scanResult);
-            }
+            _processFiles();
         }
     }
     else if(this->scanType==SCAN_TYPE_DEVICE)
     {
         if(_pDevice)
         {
-            currentStats.sStatus=tr("Device scan");
+            _setStatus(tr("Device scan"));
 
             *_pScanResult=scanDevice(_pDevice);
 
@@ -127,6 +154,16 @@ void StaticScan::process()
 void StaticScan::stop()
 {
     bIsStop=true;
+
+    QMutexLocker locker(&queueMutex);
+
+    queueNotEmpty.wakeAll();
+    queueNotFull.wakeAll();
+}
+
+void StaticScan::setCache(ScanCache *pScanCache)
+{
+    this->pScanCache=pScanCache;
 }
 
 SpecAbstract::SCAN_RESULT StaticScan::processFile(QString sFileName, SpecAbstract::SCAN_OPTIONS *pOptions)
@@ -146,11 +183,21 @@ QString StaticScan::getEngineVersion()
 
 StaticScan::STATS StaticScan::getCurrentStats()
 {
+    QMutexLocker locker(&statsMutex);
+
     if(pElapsedTimer)
     {
         currentStats.nElapsed=pElapsedTimer->elapsed();
     }
 
+    if((scanType==SCAN_TYPE_DIRECTORY)||(scanType==SCAN_TYPE_FILES)||(scanType==SCAN_TYPE_STREAM))
+    {
+        currentStats.nTotal=nTotalFiles.loadAcquire();
+        currentStats.nCurrent=nCurrentFile.loadAcquire();
+    }
+
+    currentStats.nSavedScans=scanDedup.getNumberOfSavedScans();
+
     return currentStats;
 }
 
@@ -163,12 +210,93 @@ SpecAbstract::SCAN_RESULT StaticScan::scanFile(QString sFileName)
 {
     SpecAbstract::SCAN_RESULT result= {0};
 
+    if(pScanCache)
+    {
+        // The key is taken before the scan, so a file changed meanwhile is scanned again next time
+        QByteArray baKey=pScanCache->getKey(sFileName);
+
+        if(!pScanCache->getResult(baKey,_pOptions,&result))
+        {
+            result=_scanUniqueFile(sFileName);
+
+            // An unreadable file has no records either, but they do not describe the file
+            if(QFileInfo(sFileName).isReadable())
+            {
+                pScanCache->setResult(baKey,_pOptions,&result);
+            }
+        }
+
+        result.sFileName=sFileName;
+    }
+    else
+    {
+        result=_scanUniqueFile(sFileName);
+    }
+
+    return result;
+}
+
+SpecAbstract::SCAN_RESULT StaticScan::_scanUniqueFile(QString sFileName)
+{
+    SpecAbstract::SCAN_RESULT result= {0};
+
+    if(_pOptions->bDeduplicate&&((scanType==SCAN_TYPE_DIRECTORY)||(scanType==SCAN_TYPE_FILES)||(scanType==SCAN_TYPE_STREAM)))
+    {
+        QByteArray baFingerprint;
+
+        if(!scanDedup.getResult(sFileName,&baFingerprint,&result))
+        {
+            result=_scanFile(sFileName);
+
+            scanDedup.setResult(sFileName,baFingerprint,&result);
+        }
+    }
+    else
+    {
+        result=_scanFile(sFileName);
+    }
+
+    return result;
+}
+
+SpecAbstract::SCAN_RESULT StaticScan::_scanFile(QString sFileName)
+{
+    SpecAbstract::SCAN_RESULT result= {0};
+
     QFile file;
     file.setFileName(sFileName);
 
     if(file.open(QIODevice::ReadOnly))
     {
-        result=scanDevice(&file);
+        qint64 nFileSize=file.size();
+        uchar *pMemory=nullptr;
+
+        // Opt-in: another process may truncate the file while it is scanned
+        if((_pOptions->bMapFiles)&&(nFileSize>0)&&(nFileSize<0x7FFFFFFF)) // QByteArray size limit
+        {
+            pMemory=file.map(0,nFileSize);
+        }
+
+        if(pMemory)
+        {
+            // The parsers read the mapped file directly, see XBinary::getDeviceMemory
+            QByteArray baData=QByteArray::fromRawData((char *)pMemory,(int)nFileSize);
+            QBuffer buffer(&baData);
+
+            if(buffer.open(QIODevice::ReadOnly))
+            {
+                result=scanDevice(&buffer);
+                result.sFileName=file.fileName();
+
+                buffer.close();
+            }
+
+            file.unmap(pMemory);
+        }
+        else
+        {
+            result=scanDevice(&file);
+        }
 
         file.close();
     }
@@ -176,11 +304,302 @@ SpecAbstract::SCAN_RESULT StaticScan::scanFile(QString sFileName)
     return result;
 }
 
+void StaticScan::_processFiles()
+{
+    nNextResult.storeRelease(0);
+    mapPendingResults.clear();
+    queueFiles.clear();
+    bIsEnumerated=false;
+    scanDedup.clear();
+
+    int nThreads=_pOptions->nThreads;
+
+    if(nThreads<=0)
+    {
+        nThreads=QThread::idealThreadCount();
+    }
+
+    nThreads=qMax(1,nThreads);
+
+    // One task walks the directories and fills a bounded queue, the others scan the files as they arrive
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(nThreads+1);
+
+    threadPool.start(new EnumerateFilesTask(this));
+
+    for(int i=0; i<nThreads; i++)
+    {
+        threadPool.start(new ScanFilesTask(this));
+    }
+
+    threadPool.waitForDone();
+
+    queueFiles.clear();
+    mapPendingResults.clear();
+}
+
+void StaticScan::_enumerateFiles()
+{
+    XBinary::FFOPTIONS ffoptions= {};
+    ffoptions.pbIsStop=&bIsStop;
+    ffoptions.pFileCallback=&StaticScan::_fileFound;
+    ffoptions.pUserData=this;
+
+    if(scanType==SCAN_TYPE_DIRECTORY)
+    {
+        ffoptions.bSubdirectories=_pOptions->bSubdirectories;
+
+        XBinary::findFiles(_sFileName,&ffoptions);
+    }
+    else if(scanType==SCAN_TYPE_STREAM)
+    {
+        ffoptions.bSubdirectories=true;
+
+        // Names are queued as soon as their separator arrives, the list may still be written
+        const qint64 BUFFER_SIZE=0x10000;
+        QByteArray baBuffer(BUFFER_SIZE,0);
+        QByteArray baFileName;
+
+        while(!bIsStop)
+        {
+            qint64 nRead=_readList(baBuffer.data(),BUFFER_SIZE);
+
+            if(nRead<=0)
+            {
+                break;
+            }
+
+            const char *pData=baBuffer.constData();
+            qint64 nStart=0;
+
+            for(qint64 i=0; i<nRead; i++)
+            {
+                if((pData[i]=='\n')||(pData[i]=='\0'))
+                {
+                    baFileName.append(pData+nStart,(int)(i-nStart));
+                    _nameFound(baFileName,&ffoptions);
+                    baFileName.clear();
+
+                    nStart=i+1;
+                }
+            }
+
+            // The tail is the beginning of the next name
+            baFileName.append(pData+nStart,(int)(nRead-nStart));
+        }
+
+        _nameFound(baFileName,&ffoptions);
+    }
+    else
+    {
+        ffoptions.bSubdirectories=true;
+
+        for(int i=0; (i<listFiles.count())&&(!bIsStop); i++)
+        {
+            XBinary::findFiles(listFiles.at(i),&ffoptions);
+        }
+    }
+
+    QMutexLocker locker(&queueMutex);
+
+    bIsEnumerated=true;
+    queueNotEmpty.wakeAll();
+}
+
+qint64 StaticScan::_readList(char *pData, qint64 nMaxSize)
+{
+    qint64 nResult=0;
+
+    QFile *pFile=qobject_cast<QFile *>(_pListDevice);
+    int nHandle=pFile?pFile->handle():-1;
+
+    if(nHandle!=-1)
+    {
+        // Returns what has arrived; QFile would wait on a pipe until the whole buffer is filled
+        do
+        {
+#ifdef Q_OS_WIN
+            nResult=_read(nHandle,pData,(unsigned int)nMaxSize);
+#else
+            nResult=::read(nHandle,pData,(size_t)nMaxSize);
+#endif
+        }
+        while((nResult<0)&&(errno==EINTR));
+    }
+    else
+    {
+        nResult=_pListDevice->read(pData,nMaxSize);
+    }
+
+    return nResult;
+}
+
+void StaticScan::_nameFound(QByteArray baFileName, XBinary::FFOPTIONS *pFFOptions)
+{
+    if(baFileName.endsWith('\r'))
+    {
+        baFileName.chop(1);
+    }
+
+    if(baFileName.size())
+    {
+        QString sFileName=QFile::decodeName(baFileName);
+
+        // Files keep the name they were given; a name that cannot be opened gets an empty result
+        if(QFileInfo(sFileName).isDir())
+        {
+            XBinary::findFiles(sFileName,pFFOptions);
+        }
+        else
+        {
+            _fileFound(sFileName,this);
+        }
+    }
+}
+
+void StaticScan::_fileFound(QString sFileName, void *pUserData)
+{
+    StaticScan *pStaticScan=(StaticScan *)pUserData;
+
+    QMutexLocker locker(&(pStaticScan->queueMutex));
+
+    while((pStaticScan->queueFiles.count()>=SSE_FILEQUEUESIZE)&&(!pStaticScan->bIsStop))
+    {
+        pStaticScan->queueNotFull.wait(&(pStaticScan->queueMutex),100);
+    }
+
+    qint32 nIndex=pStaticScan->nTotalFiles.fetchAndAddOrdered(1);
+
+    pStaticScan->queueFiles.enqueue(qMakePair(nIndex,sFileName));
+    pStaticScan->queueNotEmpty.wakeOne();
+}
+
+bool StaticScan::_takeFile(qint32 *pnIndex, QString *psFileName)
+{
+    bool bResult=false;
+
+    QMutexLocker locker(&queueMutex);
+
+    while(!bIsStop)
+    {
+        if(queueFiles.isEmpty())
+        {
+            if(bIsEnumerated)
+            {
+                break;
+            }
+        }
+        else if((!_pOptions->bOrderedResults)||(queueFiles.head().first-nNextResult.loadAcquire()<SSE_REORDERWINDOW))
+        {
+            break;
+        }
+
+        // Ordered results wait here for a slow file, so the pending results stay bounded
+        queueNotEmpty.wait(&queueMutex,100);
+    }
+
+    if((!queueFiles.isEmpty())&&(!bIsStop))
+    {
+        QPair<qint32,QString> record=queueFiles.dequeue();
+
+        *pnIndex=record.first;
+        *psFileName=record.second;
+
+        queueNotFull.wakeOne();
+
+        bResult=true;
+    }
+
+    return bResult;
+}
+
+void StaticScan::_scanFiles()
+{
+    qint32 nIndex=0;
+    QString sFileName;
+
+    while(_takeFile(&nIndex,&sFileName))
+    {
+        _setStatus(sFileName);
+
+        SpecAbstract::SCAN_RESULT _scanResult=scanFile(sFileName);
+        _scanResult.sFileName=sFileName;
+
+        nCurrentFile.fetchAndAddOrdered(1);
+
+        _handleResult(nIndex,&_scanResult);
+    }
+}
+
+void StaticScan::_handleResult(qint32 nIndex, SpecAbstract::SCAN_RESULT *pScanResult)
+{
+    {
+        QMutexLocker locker(&statsMutex);
+
+        currentStats.nCacheHits+=pScanResult->nCacheHits;
+        currentStats.nCacheMisses+=pScanResult->nCacheMisses;
+    }
+
+    // Results are emitted by one thread at a time, so the receivers need no locking
+    QMutexLocker locker(&resultMutex);
+
+    if(_pOptions->bOrderedResults)
+    {
+        mapPendingResults.insert(nIndex,*pScanResult);
+
+        bool bIsNext=false;
+
+        while(mapPendingResults.contains(nNextResult.loadAcquire()))
+        {
+            emit scanResult(mapPendingResults.take(nNextResult.loadAcquire()));
+
+            nNextResult.fetchAndAddOrdered(1);
+            bIsNext=true;
+        }
+
+        if(bIsNext)
+        {
+            queueNotEmpty.wakeAll();
+        }
+    }
+    else
+    {
+        emit scanResult(*pScanResult);
+    }
+}
+
+void StaticScan::_setStatus(QString sStatus)
+{
+    QMutexLocker locker(&statsMutex);
+
+    currentStats.sStatus=sStatus;
+}
+
+StaticScan::ScanFilesTask::ScanFilesTask(StaticScan *pStaticScan)
+{
+    this->pStaticScan=pStaticScan;
+}
+
+void StaticScan::ScanFilesTask::run()
+{
+    pStaticScan->_scanFiles();
+}
+
+StaticScan::EnumerateFilesTask::EnumerateFilesTask(StaticScan *pStaticScan)
+{
+    this->pStaticScan=pStaticScan;
+}
+
+void StaticScan::EnumerateFilesTask::run()
+{
+    pStaticScan->_enumerateFiles();
+}
+
 SpecAbstract::SCAN_RESULT StaticScan::scanDevice(QIODevice *pDevice)
 {
     SpecAbstract::SCAN_RESULT result= {0};
 
-    SpecAbstract::ID parentId;
+    SpecAbstract::ID parentId= {};
     parentId.filetype=SpecAbstract::RECORD_FILETYPE_UNKNOWN;
     parentId.filepart=SpecAbstract::RECORD_FILEPART_HEADER;
     _process(pDevice,&result,0,pDevice->size(),parentId,_pOptions);
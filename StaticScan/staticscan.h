@@ -25,9 +25,20 @@
 #include <QElapsedTimer>
 #include <QMutex>
 #include <QTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QPair>
 #include "specabstract.h"
+#include "scancache.h"
+#include "scandedup.h"
 
 #define SSE_VERSION "1.05"
+#define SSE_FILEQUEUESIZE 4096
+#define SSE_REORDERWINDOW 1024 // Ordered results: files taken ahead of the next result to emit
 
 class StaticScan : public QObject
 {
@@ -38,6 +49,9 @@ public:
         qint32 nTotal;
         qint32 nCurrent;
         qint64 nElapsed;
+        qint32 nSavedScans; // Duplicates answered by ScanDedup
+        qint64 nCacheHits;  // CacheDevice pages, summed over the results
+        qint64 nCacheMisses;
         QString sStatus;
     };
     explicit StaticScan(QObject *parent=nullptr);
@@ -45,6 +59,9 @@ public:
     void setData(QString sFileName,SpecAbstract::SCAN_OPTIONS *pOptions,SpecAbstract::SCAN_RESULT *pScanResult);
     void setData(QIODevice *pDevice,SpecAbstract::SCAN_OPTIONS *pOptions,SpecAbstract::SCAN_RESULT *pScanResult);
     void setData(QString sFileName,SpecAbstract::SCAN_OPTIONS *pOptions);
+    void setData(QList<QString> *pListFiles,SpecAbstract::SCAN_OPTIONS *pOptions); // Files or directories
+    void setData(QIODevice *pListDevice,SpecAbstract::SCAN_OPTIONS *pOptions); // Names separated by newlines or NULs, read while scanning
+    void setCache(ScanCache *pScanCache); // Files are looked up before they are parsed
     static SpecAbstract::SCAN_RESULT processFile(QString sFileName,SpecAbstract::SCAN_OPTIONS *pOptions);
     static QString getEngineVersion();
     STATS getCurrentStats();
@@ -54,11 +71,44 @@ private:
     {
         SCAN_TYPE_DEVICE=0,
         SCAN_TYPE_FILE,
-        SCAN_TYPE_DIRECTORY
+        SCAN_TYPE_DIRECTORY,
+        SCAN_TYPE_FILES,
+        SCAN_TYPE_STREAM
     };
+    class ScanFilesTask : public QRunnable
+    {
+    public:
+        explicit ScanFilesTask(StaticScan *pStaticScan);
+        virtual void run();
+
+    private:
+        StaticScan *pStaticScan;
+    };
+
+    class EnumerateFilesTask : public QRunnable
+    {
+    public:
+        explicit EnumerateFilesTask(StaticScan *pStaticScan);
+        virtual void run();
+
+    private:
+        StaticScan *pStaticScan;
+    };
+
     void _process(QIODevice *pDevice, SpecAbstract::SCAN_RESULT *pScanResult, qint64 nOffset, qint64 nSize, SpecAbstract::ID parentId, SpecAbstract::SCAN_OPTIONS *pOptions,int nLevel=0);
     SpecAbstract::SCAN_RESULT scanFile(QString sFileName);
+    SpecAbstract::SCAN_RESULT _scanUniqueFile(QString sFileName);
+    SpecAbstract::SCAN_RESULT _scanFile(QString sFileName);
     SpecAbstract::SCAN_RESULT scanDevice(QIODevice *pDevice);
+    void _processFiles();
+    void _enumerateFiles();
+    qint64 _readList(char *pData,qint64 nMaxSize);
+    void _nameFound(QByteArray baFileName,XBinary::FFOPTIONS *pFFOptions);
+    void _scanFiles();
+    static void _fileFound(QString sFileName,void *pUserData);
+    bool _takeFile(qint32 *pnIndex,QString *psFileName);
+    void _handleResult(qint32 nIndex,SpecAbstract::SCAN_RESULT *pScanResult);
+    void _setStatus(QString sStatus);
 
 signals:
     void completed(qint64 nElapsedTime);
@@ -73,10 +123,25 @@ private:
     QIODevice *_pDevice;
     SpecAbstract::SCAN_OPTIONS *_pOptions;
     SpecAbstract::SCAN_RESULT *_pScanResult;
+    ScanCache *pScanCache;
+    ScanDedup scanDedup;
     bool bIsStop;
     STATS currentStats;
     QElapsedTimer *pElapsedTimer;
     SCAN_TYPE scanType;
+    QMutex statsMutex;
+    QMutex resultMutex;
+    QList<QString> listFiles;
+    QIODevice *_pListDevice;
+    QMutex queueMutex;
+    QWaitCondition queueNotEmpty;
+    QWaitCondition queueNotFull;
+    QQueue<QPair<qint32,QString> > queueFiles;
+    bool bIsEnumerated;
+    QAtomicInt nTotalFiles;
+    QAtomicInt nCurrentFile;
+    QAtomicInt nNextResult;
+    QMap<qint32,SpecAbstract::SCAN_RESULT> mapPendingResults;
 };
 
 #endif // STATICSCAN_H
@@ -3,11 +3,15 @@ DEPENDPATH += $$PWD
 
 HEADERS += \
     $$PWD/staticscan.h \
+    $$PWD/scancache.h \
+    $$PWD/scandedup.h \
     $$PWD/staticscanitem.h \
     $$PWD/staticscanitemmodel.h
 
 SOURCES += \
     $$PWD/staticscan.cpp \
+    $$PWD/scancache.cpp \
+    $$PWD/scandedup.cpp \
     $$PWD/staticscanitem.cpp \
     $$PWD/staticscanitemmodel.cpp
 
@@ -25,22 +25,18 @@ StaticScanItemModel::StaticScanItemModel(QList<SpecAbstract::SCAN_STRUCT> *pList
 {
     _rootItem=new StaticScanItem(tr("Result"),nullptr,nColumnCount);
 
-    QMap<QString,StaticScanItem *> mapParents;
+    // The IDs may come from a cache file, so they are not trusted to be small
+    QHash<quint32,StaticScanItem *> mapParents;
+    mapParents.reserve(pListDetects->count());
 
     for(int i=0; i<pListDetects->count(); i++)
     {
-        if(!mapParents.contains(pListDetects->at(i).id.uuid.toString()))
-        {
-            StaticScanItem *_itemParent;
+        quint32 nId=pListDetects->at(i).id.nId;
 
-            if(pListDetects->at(i).parentId.uuid=="")
-            {
-                _itemParent=_rootItem;
-            }
-            else
-            {
-                _itemParent=mapParents.value(pListDetects->at(i).parentId.uuid.toString());
-            }
+        if(!mapParents.contains(nId))
+        {
+            quint32 nParentId=pListDetects->at(i).parentId.nId;
+            StaticScanItem *_itemParent=mapParents.value(nParentId,_rootItem);
 
             QString sParent=SpecAbstract::createTypeString(&pListDetects->at(i));
 
@@ -48,10 +44,10 @@ StaticScanItemModel::StaticScanItemModel(QList<SpecAbstract::SCAN_STRUCT> *pList
             itemParent->setScanStruct(SpecAbstract::createHeaderScanStruct(&pListDetects->at(i)));
             _itemParent->appendChild(itemParent);
 
-            mapParents.insert(pListDetects->at(i).id.uuid.toString(),itemParent);
+            mapParents.insert(nId,itemParent);
         }
 
-        StaticScanItem *itemParent=mapParents.value(pListDetects->at(i).id.uuid.toString());
+        StaticScanItem *itemParent=mapParents.value(nId);
 
         QString sItem=SpecAbstract::createResultString2(&pListDetects->at(i));
         StaticScanItem *item=new StaticScanItem(sItem,itemParent,nColumnCount);
@@ -1,4 +1,7 @@
 # For additional build parameters
+# C++14 constexpr is used for the signature tables, older compilers build them at startup
+CONFIG += c++14
+
 CONFIG(debug, debug|release) {
     DESTDIR = ../build/debug
 } else {
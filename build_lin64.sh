@@ -30,6 +30,7 @@ rm -rf $SOURCE_PATH/build
 
 makeproject gui_source
 makeproject console_source
+makeproject lib_source
 
 mkdir -p release
 rm -rf release/$BUILD_NAME
@@ -41,6 +42,7 @@ cp -R $QT_PATH/plugins/platforms/libqxcb.so                     $SOURCE_PATH/rel
 
 cp -R $SOURCE_PATH/build/release/nfd                           $SOURCE_PATH/release/$BUILD_NAME/base/
 cp -R $SOURCE_PATH/build/release/nfdc                          $SOURCE_PATH/release/$BUILD_NAME/base/
+cp -R $SOURCE_PATH/build/release/libnfd.so*                    $SOURCE_PATH/release/$BUILD_NAME/base/
 
 cp -R $QT_PATH/lib/libQt5Core.so.5.6.3                          $SOURCE_PATH/release/$BUILD_NAME/base/
 cp -R $QT_PATH/lib/libQt5Gui.so.5.6.3                           $SOURCE_PATH/release/$BUILD_NAME/base/
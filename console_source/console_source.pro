@@ -3,8 +3,6 @@ QT -= gui
 
 include(../build.pri)
 
-CONFIG += c++11
-
 TARGET = nfdc
 CONFIG += console
 CONFIG -= app_bundle
@@ -14,6 +12,14 @@ TEMPLATE = app
 SOURCES += \
     main_console.cpp
 
+unix {
+    HEADERS += \
+        scanserver.h
+
+    SOURCES += \
+        scanserver.cpp
+}
+
 !contains(XCONFIG, staticscan) {
     XCONFIG += staticscan
     include(../StaticScan/staticscan.pri)
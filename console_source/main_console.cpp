@@ -21,67 +21,119 @@
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QCommandLineOption>
+#include <QJsonDocument>
+#include <QJsonArray>
 #include "staticscanitemmodel.h"
+#ifdef Q_OS_UNIX
+#include "scanserver.h"
+#endif
 #include "../global.h"
 
-// TODO QBinary
-void FindFiles(QString sFileName,QList<QString> *pListFileNames)
+void ScanFiles(QList<QString> *pListArgs,bool bStdin,bool bNDJSON,SpecAbstract::SCAN_OPTIONS *pScanOptions,ScanCache *pScanCache)
 {
-    if((sFileName!=".")&&(sFileName!=".."))
+    QList<QString> listFileNames;
+    bool bShowFileName=bStdin;
+
+    for(int i=0;i<pListArgs->count();i++)
     {
+        QString sFileName=pListArgs->at(i);
+
         QFileInfo fi(sFileName);
 
-        if(fi.isFile())
+        if(fi.exists())
         {
-            pListFileNames->append(fi.absoluteFilePath());
-        }
-        else if(fi.isDir())
-        {
-            QDir dir(sFileName);
-
-            QFileInfoList eil=dir.entryInfoList();
+            listFileNames.append(sFileName);
 
-            for(int i=0;i<eil.count();i++)
+            if(fi.isDir())
             {
-                FindFiles(eil.at(i).absoluteFilePath(),pListFileNames);
+                bShowFileName=true;
             }
         }
+        else
+        {
+            fprintf(bNDJSON?stderr:stdout,"Cannot find: %s\n",sFileName.toLatin1().data());
+        }
     }
-}
 
-void ScanFiles(QList<QString> *pListArgs,SpecAbstract::SCAN_OPTIONS *pScanOptions)
-{
-    QList<QString> listFileNames;
-
-    for(int i=0;i<pListArgs->count();i++)
+    if(listFileNames.count()>1)
     {
-        QString sFileName=pListArgs->at(i);
+        bShowFileName=true;
+    }
+
+    // Directories are walked while the files are scanned; StaticScan emits one result at a time,
+    // so the output of the workers does not interleave
+    StaticScan scan;
 
-        if(QFileInfo::exists(sFileName))
+    QObject::connect(&scan,&StaticScan::scanResult,[=](SpecAbstract::SCAN_RESULT scanResult)
+    {
+        if(bNDJSON)
         {
-            FindFiles(sFileName,&listFileNames);
+            // One line per file, built from the records without the tree model
+            QJsonObject jsonResult;
+            QJsonArray jsonRecords;
+
+            for(int i=0;i<scanResult.listRecords.count();i++)
+            {
+                jsonRecords.append(SpecAbstract::createJsonObject(&(scanResult.listRecords.at(i))));
+            }
+
+            jsonResult.insert("path",scanResult.sFileName);
+            jsonResult.insert("scantime",(double)scanResult.nScanTime);
+            jsonResult.insert("cachehits",(double)scanResult.nCacheHits);
+            jsonResult.insert("cachemisses",(double)scanResult.nCacheMisses);
+            jsonResult.insert("records",jsonRecords);
+
+            QByteArray baLine=QJsonDocument(jsonResult).toJson(QJsonDocument::Compact);
+            baLine.append('\n');
+
+            fwrite(baLine.constData(),1,baLine.size(),stdout);
         }
         else
         {
-            printf("Cannot find: %s\n",sFileName.toLatin1().data());
+            StaticScanItemModel model(&scanResult.listRecords);
+
+            QString sResult;
+
+            if(bShowFileName)
+            {
+                sResult+=QString("%1:\n").arg(scanResult.sFileName);
+            }
+
+            sResult+=model.toString(pScanOptions);
+
+            printf("%s\n",sResult.toLatin1().data());
         }
-    }
 
-    bool bShowFileName=listFileNames.count()>1;
+        fflush(stdout);
+    });
+
+    QFile fileStdin;
 
-    for(int i=0;i<listFileNames.count();i++)
+    if(bStdin)
     {
-        QString sFileName=listFileNames.at(i);
+        // Unbuffered: a buffered read would wait for a full buffer before the first name is scanned
+        fileStdin.open(fileno(stdin),QIODevice::ReadOnly|QIODevice::Unbuffered);
 
-        if(bShowFileName)
-        {
-            printf("%s:\n",sFileName.toLatin1().data());
-        }
+        scan.setData(&fileStdin,pScanOptions);
+    }
+    else
+    {
+        scan.setData(&listFileNames,pScanOptions);
+    }
+
+    scan.setCache(pScanCache);
+    scan.process();
 
-        SpecAbstract::SCAN_RESULT scanResult=StaticScan::processFile(sFileName,pScanOptions);
-        StaticScanItemModel model(&scanResult.listRecords);
+    StaticScan::STATS stats=scan.getCurrentStats();
 
-        printf("%s\n",model.toString(pScanOptions).toLatin1().data());
+    if(stats.nSavedScans)
+    {
+        fprintf(stderr,"Duplicates: %d\n",stats.nSavedScans);
+    }
+
+    if(stats.nCacheHits||stats.nCacheMisses)
+    {
+        fprintf(stderr,"Page cache: %lld hits, %lld misses\n",(long long)stats.nCacheHits,(long long)stats.nCacheMisses);
     }
 }
 
@@ -113,6 +165,35 @@ int main(int argc, char *argv[])
     QCommandLineOption clResultAsXml(QStringList()<<"x"<<"xml","Result as XML.");
     parser.addOption(clResultAsXml);
 
+    QCommandLineOption clJobs(QStringList()<<"j"<<"jobs","Number of files scanned in parallel (0 - number of cores).","N","1");
+    parser.addOption(clJobs);
+
+    QCommandLineOption clOrdered(QStringList()<<"ordered","Print results in the order of the input files.");
+    parser.addOption(clOrdered);
+
+    QCommandLineOption clCache(QStringList()<<"c"<<"cache","Keep the results in a cache file and reuse them for unchanged files.","file");
+    parser.addOption(clCache);
+
+    QCommandLineOption clCacheHash(QStringList()<<"cache-hash","Compare the contents of the files with the cache too.");
+    parser.addOption(clCacheHash);
+
+    QCommandLineOption clDedup(QStringList()<<"dedup","Scan byte-identical files once and reuse the result.");
+    parser.addOption(clDedup);
+
+    QCommandLineOption clMmap(QStringList()<<"mmap","Map the files into memory. Faster, but a file truncated during its scan stops nfdc with SIGBUS.");
+    parser.addOption(clMmap);
+
+    QCommandLineOption clStdin(QStringList()<<"stdin","Read the file names from the standard input, separated by newlines or NULs.");
+    parser.addOption(clStdin);
+
+    QCommandLineOption clFormat(QStringList()<<"format","Output format: text or ndjson (one JSON object per file).","format","text");
+    parser.addOption(clFormat);
+
+#ifdef Q_OS_UNIX
+    QCommandLineOption clServe(QStringList()<<"serve","Answer scan requests on a Unix domain socket until SIGINT/SIGTERM.","socket");
+    parser.addOption(clServe);
+#endif
+
     parser.process(app);
 
     QList<QString> listArgs=parser.positionalArguments();
@@ -123,9 +204,64 @@ int main(int argc, char *argv[])
     scanOptions.bDeepScan=parser.isSet(clDeepScan);
     scanOptions.bResultAsXML=parser.isSet(clResultAsXml);
 
-    if(listArgs.count())
+    bool bJobsValid=false;
+    scanOptions.nThreads=parser.value(clJobs).toInt(&bJobsValid);
+
+    if((!bJobsValid)||(scanOptions.nThreads<0))
+    {
+        scanOptions.nThreads=1;
+    }
+
+    scanOptions.bOrderedResults=parser.isSet(clOrdered);
+    scanOptions.bDeduplicate=parser.isSet(clDedup);
+    scanOptions.bMapFiles=parser.isSet(clMmap);
+
+    QString sFormat=parser.value(clFormat);
+
+    if((sFormat!="text")&&(sFormat!="ndjson"))
     {
-        ScanFiles(&listArgs,&scanOptions);
+        printf("Unknown format: %s\n",sFormat.toLatin1().data());
+
+        return 1;
+    }
+
+#ifdef Q_OS_UNIX
+    if(parser.isSet(clServe))
+    {
+        ScanServer scanServer;
+
+        if(!scanServer.listen(parser.value(clServe),&scanOptions))
+        {
+            printf("Cannot listen: %s\n",scanServer.getErrorString().toLatin1().data());
+
+            return 1;
+        }
+
+        scanServer.exec();
+    }
+    else
+#endif
+    if(listArgs.count()||parser.isSet(clStdin))
+    {
+        ScanCache *pScanCache=nullptr;
+
+        if(parser.isSet(clCache))
+        {
+            pScanCache=new ScanCache;
+            pScanCache->open(parser.value(clCache),parser.isSet(clCacheHash));
+        }
+
+        ScanFiles(&listArgs,parser.isSet(clStdin),(sFormat=="ndjson"),&scanOptions,pScanCache);
+
+        if(pScanCache)
+        {
+            if(!pScanCache->save())
+            {
+                fprintf(stderr,"Cannot save: %s\n",parser.value(clCache).toLatin1().data());
+            }
+
+            delete pScanCache;
+        }
     }
     else
     {
@@ -0,0 +1,620 @@
+// Copyright (c) 2018-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "scanserver.h"
+#include <QtEndian>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+#ifdef MSG_CMSG_CLOEXEC
+#define SSV_RECVFLAGS MSG_CMSG_CLOEXEC
+#else
+#define SSV_RECVFLAGS 0
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define SSV_SENDFLAGS MSG_NOSIGNAL
+#else
+#define SSV_SENDFLAGS 0
+#endif
+
+// Written once by stop(); every thread polls the read end, so it wakes all of them
+static int _nStopPipe[2]= {-1,-1};
+
+ScanServer::ScanServer(QObject *parent) : QObject(parent)
+{
+    nListenSocket=-1;
+    options=SpecAbstract::SCAN_OPTIONS();
+}
+
+ScanServer::~ScanServer()
+{
+    if(nListenSocket!=-1)
+    {
+        close(nListenSocket);
+        unlink(QFile::encodeName(sSocketName).constData());
+    }
+
+    for(int i=0; i<2; i++)
+    {
+        if(_nStopPipe[i]!=-1)
+        {
+            close(_nStopPipe[i]);
+            _nStopPipe[i]=-1;
+        }
+    }
+}
+
+bool ScanServer::listen(QString sSocketName, SpecAbstract::SCAN_OPTIONS *pOptions)
+{
+    bool bResult=false;
+
+    this->sSocketName=sSocketName;
+    this->options=*pOptions;
+
+    int nThreads=pOptions->nThreads;
+
+    if(nThreads<=0)
+    {
+        nThreads=QThread::idealThreadCount();
+    }
+
+    semaphoreScans.release(qMax(1,nThreads));
+    threadPool.setMaxThreadCount(SSV_MAXCONNECTIONS);
+
+    QByteArray baSocketName=QFile::encodeName(sSocketName);
+
+    struct sockaddr_un address;
+    memset(&address,0,sizeof(address));
+    address.sun_family=AF_UNIX;
+
+    if(baSocketName.size()>=(int)sizeof(address.sun_path))
+    {
+        sErrorString=tr("Socket name is too long");
+    }
+    else if(pipe(_nStopPipe)!=0)
+    {
+        sErrorString=QString::fromLocal8Bit(strerror(errno));
+    }
+    else
+    {
+        fcntl(_nStopPipe[0],F_SETFD,FD_CLOEXEC);
+        fcntl(_nStopPipe[1],F_SETFD,FD_CLOEXEC);
+
+        memcpy(address.sun_path,baSocketName.constData(),baSocketName.size());
+
+        bool bCanBind=false;
+        struct stat st;
+
+        if(lstat(baSocketName.constData(),&st)!=0)
+        {
+            if(errno==ENOENT)
+            {
+                bCanBind=true;
+            }
+            else
+            {
+                sErrorString=QString::fromLocal8Bit(strerror(errno));
+            }
+        }
+        else if(!S_ISSOCK(st.st_mode))
+        {
+            // Never remove anything but a socket
+            sErrorString=tr("File exists and is not a socket");
+        }
+        else
+        {
+            // Only a socket nobody answers on is left over from a previous run
+            int nProbeSocket=socket(AF_UNIX,SOCK_STREAM,0);
+
+            if(nProbeSocket==-1)
+            {
+                sErrorString=QString::fromLocal8Bit(strerror(errno));
+            }
+            else if(::connect(nProbeSocket,(struct sockaddr *)&address,sizeof(address))==0)
+            {
+                sErrorString=tr("Socket is in use");
+            }
+            else if(errno!=ECONNREFUSED)
+            {
+                sErrorString=QString::fromLocal8Bit(strerror(errno));
+            }
+            else if(unlink(baSocketName.constData())!=0)
+            {
+                sErrorString=QString::fromLocal8Bit(strerror(errno));
+            }
+            else
+            {
+                bCanBind=true;
+            }
+
+            if(nProbeSocket!=-1)
+            {
+                close(nProbeSocket);
+            }
+        }
+
+        if(bCanBind)
+        {
+            nListenSocket=socket(AF_UNIX,SOCK_STREAM,0);
+
+            if(nListenSocket!=-1)
+            {
+                fcntl(nListenSocket,F_SETFD,FD_CLOEXEC);
+
+                // Clients make the daemon open files as its owner: only the owner may connect.
+                // Nobody can connect before listen(), so the umask does not matter in between
+                if(bind(nListenSocket,(struct sockaddr *)&address,sizeof(address))!=0)
+                {
+                    sErrorString=QString::fromLocal8Bit(strerror(errno));
+
+                    close(nListenSocket);
+                    nListenSocket=-1;
+                }
+                else if((chmod(baSocketName.constData(),S_IRUSR|S_IWUSR)!=0)||(::listen(nListenSocket,SOMAXCONN)!=0))
+                {
+                    sErrorString=QString::fromLocal8Bit(strerror(errno));
+
+                    close(nListenSocket);
+                    nListenSocket=-1;
+                    unlink(baSocketName.constData());
+                }
+                else
+                {
+                    bResult=true;
+                }
+            }
+            else
+            {
+                sErrorString=QString::fromLocal8Bit(strerror(errno));
+            }
+        }
+    }
+
+    return bResult;
+}
+
+void ScanServer::exec()
+{
+    signal(SIGPIPE,SIG_IGN);
+    signal(SIGINT,&ScanServer::_signalHandler);
+    signal(SIGTERM,&ScanServer::_signalHandler);
+
+    bool bIsStop=false;
+
+    while(!bIsStop)
+    {
+        struct pollfd fds[2];
+        fds[0].fd=nListenSocket;
+        fds[0].events=POLLIN;
+        fds[0].revents=0;
+        fds[1].fd=_nStopPipe[0];
+        fds[1].events=POLLIN;
+        fds[1].revents=0;
+
+        if(poll(fds,2,-1)<0)
+        {
+            bIsStop=(errno!=EINTR);
+        }
+        else if(fds[1].revents)
+        {
+            bIsStop=true;
+        }
+        else if(fds[0].revents&POLLIN)
+        {
+            int nSocket=accept(nListenSocket,nullptr,nullptr);
+
+            if(nSocket!=-1)
+            {
+                fcntl(nSocket,F_SETFD,FD_CLOEXEC);
+
+                // A client which does not read its answer cannot hold the thread
+                struct timeval timeout;
+                timeout.tv_sec=SSV_IOTIMEOUT/1000;
+                timeout.tv_usec=(SSV_IOTIMEOUT%1000)*1000;
+                setsockopt(nSocket,SOL_SOCKET,SO_SNDTIMEO,&timeout,sizeof(timeout));
+
+                // Every connection has its own thread; over the limit it would wait in the queue without an answer
+                if(nConnections.fetchAndAddOrdered(1)<SSV_MAXCONNECTIONS)
+                {
+                    threadPool.start(new ConnectionTask(this,nSocket));
+                }
+                else
+                {
+                    nConnections.fetchAndAddOrdered(-1);
+
+                    QJsonObject jsonResult;
+                    jsonResult.insert("status","error");
+                    jsonResult.insert("error",tr("Too many connections"));
+
+                    _writeFrame(nSocket,QJsonDocument(jsonResult).toJson(QJsonDocument::Compact));
+
+                    close(nSocket);
+                }
+            }
+        }
+    }
+
+    // Drain: no new connections; the connections stop after the request they are scanning
+    close(nListenSocket);
+    nListenSocket=-1;
+    unlink(QFile::encodeName(sSocketName).constData());
+
+    threadPool.waitForDone();
+}
+
+void ScanServer::stop()
+{
+    if(_nStopPipe[1]!=-1)
+    {
+        ssize_t nResult=write(_nStopPipe[1],"s",1);
+        Q_UNUSED(nResult);
+    }
+}
+
+QString ScanServer::getErrorString()
+{
+    return sErrorString;
+}
+
+void ScanServer::_handleConnection(int nSocket)
+{
+    while(_waitForRequest(nSocket))
+    {
+        QByteArray baRequest;
+        QList<int> listFds;
+
+        bool bIsValid=_readFrame(nSocket,&baRequest,&listFds);
+
+        if(bIsValid)
+        {
+            QJsonObject jsonResult;
+            QJsonParseError jsonError;
+
+            QJsonDocument jsonRequest=QJsonDocument::fromJson(baRequest,&jsonError);
+
+            if(jsonRequest.isObject())
+            {
+                jsonResult=_handleRequest(jsonRequest.object(),&listFds);
+            }
+            else
+            {
+                jsonResult.insert("status","error");
+                jsonResult.insert("error",jsonError.errorString());
+            }
+
+            bIsValid=_writeFrame(nSocket,QJsonDocument(jsonResult).toJson(QJsonDocument::Compact));
+        }
+
+        // Descriptors the request did not use
+        for(int i=0; i<listFds.count(); i++)
+        {
+            close(listFds.at(i));
+        }
+
+        if(!bIsValid)
+        {
+            break;
+        }
+    }
+
+    close(nSocket);
+
+    nConnections.fetchAndAddOrdered(-1);
+}
+
+QJsonObject ScanServer::_handleRequest(QJsonObject jsonRequest, QList<int> *pListFds)
+{
+    QJsonObject result;
+
+    if(jsonRequest.contains("id"))
+    {
+        result.insert("id",jsonRequest.value("id"));
+    }
+
+    SpecAbstract::SCAN_OPTIONS _options=options;
+
+    if(jsonRequest.contains("recursive"))
+    {
+        _options.bRecursive=jsonRequest.value("recursive").toBool();
+    }
+
+    if(jsonRequest.contains("deepscan"))
+    {
+        _options.bDeepScan=jsonRequest.value("deepscan").toBool();
+    }
+
+    SpecAbstract::SCAN_RESULT scanResult= {0};
+    QString sError;
+
+    if(jsonRequest.value("fd").toBool())
+    {
+        if(pListFds->count())
+        {
+            int nFd=pListFds->takeFirst();
+
+            QFile file;
+
+            if(file.open(nFd,QIODevice::ReadOnly,QFileDevice::AutoCloseHandle))
+            {
+                semaphoreScans.acquire();
+
+                StaticScan scan;
+                scan.setData(&file,&_options,&scanResult);
+                scan.process();
+
+                semaphoreScans.release();
+
+                file.close();
+            }
+            else
+            {
+                close(nFd);
+
+                sError=tr("Cannot open the descriptor");
+            }
+        }
+        else
+        {
+            sError=tr("No descriptor attached");
+        }
+    }
+    else if(jsonRequest.contains("path"))
+    {
+        QString sFileName=jsonRequest.value("path").toString();
+
+        if(QFileInfo(sFileName).isFile())
+        {
+            semaphoreScans.acquire();
+
+            scanResult=StaticScan::processFile(sFileName,&_options);
+
+            semaphoreScans.release();
+
+            result.insert("filename",sFileName);
+        }
+        else
+        {
+            sError=QString("%1: %2").arg(tr("Cannot find")).arg(sFileName);
+        }
+    }
+    else
+    {
+        sError=tr("No path or fd");
+    }
+
+    if(sError=="")
+    {
+        QJsonArray jsonRecords;
+
+        for(int i=0; i<scanResult.listRecords.count(); i++)
+        {
+            jsonRecords.append(SpecAbstract::createJsonObject(&(scanResult.listRecords.at(i))));
+        }
+
+        result.insert("status","ok");
+        result.insert("scantime",(double)scanResult.nScanTime);
+        result.insert("cachehits",(double)scanResult.nCacheHits);
+        result.insert("cachemisses",(double)scanResult.nCacheMisses);
+        result.insert("records",jsonRecords);
+    }
+    else
+    {
+        result.insert("status","error");
+        result.insert("error",sError);
+    }
+
+    return result;
+}
+
+bool ScanServer::_waitForRequest(int nSocket)
+{
+    return _pollSocket(nSocket,SSV_IDLETIMEOUT);
+}
+
+bool ScanServer::_pollSocket(int nSocket, qint64 nTimeout)
+{
+    bool bResult=false;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while(true)
+    {
+        qint64 nRemaining=nTimeout-timer.elapsed();
+
+        if(nRemaining<=0)
+        {
+            break;
+        }
+
+        struct pollfd fds[2];
+        fds[0].fd=nSocket;
+        fds[0].events=POLLIN;
+        fds[0].revents=0;
+        fds[1].fd=_nStopPipe[0];
+        fds[1].events=POLLIN;
+        fds[1].revents=0;
+
+        if(poll(fds,2,(int)nRemaining)<0)
+        {
+            if(errno==EINTR)
+            {
+                continue;
+            }
+        }
+        else if(!fds[1].revents)
+        {
+            // A closed connection is readable too; the read then fails. No events is the timeout
+            bResult=(fds[0].revents!=0);
+        }
+
+        break;
+    }
+
+    return bResult;
+}
+
+bool ScanServer::_readFrame(int nSocket, QByteArray *pbaData, QList<int> *pListFds)
+{
+    bool bResult=false;
+
+    uchar header[4];
+
+    // The whole frame has to arrive within SSV_IOTIMEOUT
+    QElapsedTimer timer;
+    timer.start();
+
+    if(_readData(nSocket,(char *)header,sizeof(header),pListFds,&timer))
+    {
+        quint32 nSize=qFromBigEndian<quint32>(header);
+
+        if(nSize<=SSV_MAXFRAMESIZE)
+        {
+            pbaData->resize(nSize);
+
+            bResult=_readData(nSocket,pbaData->data(),nSize,pListFds,&timer);
+        }
+    }
+
+    return bResult;
+}
+
+bool ScanServer::_readData(int nSocket, char *pData, qint32 nSize, QList<int> *pListFds, QElapsedTimer *pTimer)
+{
+    bool bResult=true;
+
+    while(bResult&&(nSize>0))
+    {
+        // Fails on the deadline and on stop()
+        if(!_pollSocket(nSocket,SSV_IOTIMEOUT-pTimer->elapsed()))
+        {
+            bResult=false;
+
+            break;
+        }
+
+        struct iovec iov;
+        iov.iov_base=pData;
+        iov.iov_len=nSize;
+
+        union
+        {
+            struct cmsghdr header;
+            char buffer[CMSG_SPACE(sizeof(int)*SSV_MAXFDS)];
+        } control;
+
+        struct msghdr message;
+        memset(&message,0,sizeof(message));
+        message.msg_iov=&iov;
+        message.msg_iovlen=1;
+        message.msg_control=control.buffer;
+        message.msg_controllen=sizeof(control.buffer);
+
+        ssize_t nRead=recvmsg(nSocket,&message,SSV_RECVFLAGS);
+
+        if(nRead>0)
+        {
+            for(struct cmsghdr *pHeader=CMSG_FIRSTHDR(&message); pHeader; pHeader=CMSG_NXTHDR(&message,pHeader))
+            {
+                if((pHeader->cmsg_level==SOL_SOCKET)&&(pHeader->cmsg_type==SCM_RIGHTS))
+                {
+                    int nNumberOfFds=(pHeader->cmsg_len-CMSG_LEN(0))/sizeof(int);
+
+                    for(int i=0; i<nNumberOfFds; i++)
+                    {
+                        int nFd=-1;
+                        memcpy(&nFd,CMSG_DATA(pHeader)+i*sizeof(int),sizeof(int));
+
+                        pListFds->append(nFd);
+                    }
+                }
+            }
+
+            pData+=nRead;
+            nSize-=nRead;
+        }
+        else if((nRead<0)&&(errno==EINTR))
+        {
+            // Interrupted by a signal, retry
+        }
+        else
+        {
+            bResult=false;
+        }
+    }
+
+    return bResult;
+}
+
+bool ScanServer::_writeFrame(int nSocket, QByteArray baData)
+{
+    QByteArray baFrame(4,0);
+    qToBigEndian<quint32>((quint32)baData.size(),(uchar *)baFrame.data());
+    baFrame.append(baData);
+
+    const char *pData=baFrame.constData();
+    qint64 nSize=baFrame.size();
+
+    bool bResult=true;
+
+    while(bResult&&(nSize>0))
+    {
+        ssize_t nWritten=send(nSocket,pData,nSize,SSV_SENDFLAGS);
+
+        if(nWritten>0)
+        {
+            pData+=nWritten;
+            nSize-=nWritten;
+        }
+        else if(!((nWritten<0)&&(errno==EINTR)))
+        {
+            bResult=false;
+        }
+    }
+
+    return bResult;
+}
+
+void ScanServer::_signalHandler(int nSignal)
+{
+    Q_UNUSED(nSignal);
+
+    stop();
+}
+
+ScanServer::ConnectionTask::ConnectionTask(ScanServer *pScanServer, int nSocket)
+{
+    this->pScanServer=pScanServer;
+    this->nSocket=nSocket;
+}
+
+void ScanServer::ConnectionTask::run()
+{
+    pScanServer->_handleConnection(nSocket);
+}
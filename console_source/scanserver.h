@@ -0,0 +1,89 @@
+// Copyright (c) 2018-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef SCANSERVER_H
+#define SCANSERVER_H
+
+#include <QObject>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include "staticscan.h"
+
+#define SSV_MAXFRAMESIZE 0x100000
+#define SSV_MAXCONNECTIONS 64
+#define SSV_MAXFDS 4
+#define SSV_IDLETIMEOUT 60000   // ms a connection may wait between requests
+#define SSV_IOTIMEOUT 10000     // ms to receive a whole frame or to send an answer
+
+// Every message is a JSON object preceded by its size as a big-endian quint32.
+// Request: {"id":..,"path":"file"} or {"id":..,"fd":true} with the descriptor sent as SCM_RIGHTS,
+// optionally "recursive" and "deepscan". Answer: {"id":..,"status":"ok","records":[..]} or {"status":"error","error":".."}
+// Connections over SSV_MAXCONNECTIONS get an error answer and are closed; idle or stalled connections are closed too.
+class ScanServer : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ScanServer(QObject *parent=nullptr);
+    ~ScanServer();
+
+    bool listen(QString sSocketName,SpecAbstract::SCAN_OPTIONS *pOptions); // nThreads limits the concurrent scans
+    void exec(); // Returns after stop(), when the requests being scanned are answered
+    static void stop(); // Async-signal-safe; SIGINT and SIGTERM call it
+    QString getErrorString();
+
+private:
+    class ConnectionTask : public QRunnable
+    {
+    public:
+        explicit ConnectionTask(ScanServer *pScanServer,int nSocket);
+        virtual void run();
+
+    private:
+        ScanServer *pScanServer;
+        int nSocket;
+    };
+
+    void _handleConnection(int nSocket);
+    QJsonObject _handleRequest(QJsonObject jsonRequest,QList<int> *pListFds);
+    static bool _waitForRequest(int nSocket);
+    static bool _readFrame(int nSocket,QByteArray *pbaData,QList<int> *pListFds);
+    static bool _readData(int nSocket,char *pData,qint32 nSize,QList<int> *pListFds,QElapsedTimer *pTimer);
+    static bool _pollSocket(int nSocket,qint64 nTimeout);
+    static bool _writeFrame(int nSocket,QByteArray baData);
+    static void _signalHandler(int nSignal);
+
+    QString sSocketName;
+    QString sErrorString;
+    int nListenSocket;
+    SpecAbstract::SCAN_OPTIONS options;
+    QSemaphore semaphoreScans;
+    QAtomicInt nConnections;
+    QThreadPool threadPool;
+};
+
+#endif // SCANSERVER_H
@@ -90,6 +90,7 @@ void DialogDirectoryScan::scanDirectory(QString sDirectoryName)
         options.bRecursive=ui->checkBoxRecursive->isChecked();
         options.bDeepScan=ui->checkBoxDeepScan->isChecked();
         options.bSubdirectories=ui->checkBoxScanSubdirectories->isChecked();
+        options.bDeduplicate=true;
         // TODO Filter
         // |flags|x all|
 
@@ -50,11 +50,13 @@ void GuiMainWindow::scanFile(QString sFileName)
 {
     if(sFileName!="")
     {
-        SpecAbstract::SCAN_RESULT scanResult;
+        SpecAbstract::SCAN_RESULT scanResult= {0};
 
         SpecAbstract::SCAN_OPTIONS options= {0};
         options.bRecursive=ui->checkBoxRecursive->isChecked();
         options.bDeepScan=ui->checkBoxDeepScan->isChecked();
+        options.bParallelDetects=true;
+        options.bMapFiles=true; // One file the user picked; the handlers run in parallel only on memory
 
         DialogStaticScan ds(this);
         ds.setData(sFileName,&options,&scanResult);
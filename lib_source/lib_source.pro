@@ -0,0 +1,22 @@
+QT += core
+QT -= gui
+
+include(../build.pri)
+
+TARGET = nfd
+TEMPLATE = lib
+CONFIG += shared
+CONFIG += hide_symbols
+
+DEFINES += NFD_LIBRARY
+
+HEADERS += \
+    nfd.h
+
+SOURCES += \
+    nfd.cpp
+
+!contains(XCONFIG, staticscan) {
+    XCONFIG += staticscan
+    include(../StaticScan/staticscan.pri)
+}
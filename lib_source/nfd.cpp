@@ -0,0 +1,239 @@
+// Copyright (c) 2018-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#include "nfd.h"
+#include "staticscan.h"
+
+struct NFD_ENGINE
+{
+    SpecAbstract::SCAN_OPTIONS options;
+};
+
+struct NFD_RESULT
+{
+    qint64 nScanTime;
+    QList<QByteArray> listStrings; // The record strings point here
+    QVector<NFD_RECORD> listRecords;
+};
+
+static const char *_addString(NFD_RESULT *pResult,QString sString)
+{
+    pResult->listStrings.append(sString.toUtf8());
+
+    return pResult->listStrings.last().constData();
+}
+
+static NFD_RESULT *_createResult(SpecAbstract::SCAN_RESULT *pScanResult)
+{
+    NFD_RESULT *pResult=new NFD_RESULT;
+    pResult->nScanTime=pScanResult->nScanTime;
+
+    // The first record of every ID; the IDs may come from a cache file, so they are not trusted to be small
+    QHash<quint32,int> mapIndexes;
+    mapIndexes.reserve(pScanResult->listRecords.count());
+
+    for(int i=0; i<pScanResult->listRecords.count(); i++)
+    {
+        quint32 nId=pScanResult->listRecords.at(i).id.nId;
+
+        if(!mapIndexes.contains(nId))
+        {
+            mapIndexes.insert(nId,i);
+        }
+    }
+
+    for(int i=0; i<pScanResult->listRecords.count(); i++)
+    {
+        const SpecAbstract::SCAN_STRUCT *pScanStruct=&(pScanResult->listRecords.at(i));
+
+        NFD_RECORD record= {};
+        record.pszFiletype=_addString(pResult,SpecAbstract::recordFiletypeIdToString(pScanStruct->id.filetype));
+        record.pszType=_addString(pResult,SpecAbstract::recordTypeIdToString(pScanStruct->type));
+        record.pszName=_addString(pResult,SpecAbstract::recordNameIdToString(pScanStruct->name));
+        record.pszVersion=_addString(pResult,pScanStruct->sVersion);
+        record.pszInfo=_addString(pResult,pScanStruct->sInfo);
+        record.pszString=_addString(pResult,SpecAbstract::createResultString2(pScanStruct));
+        record.nOffset=pScanStruct->nOffset;
+        record.nSize=pScanStruct->nSize;
+        record.nParent=mapIndexes.value(pScanStruct->parentId.nId,-1);
+
+        pResult->listRecords.append(record);
+    }
+
+    return pResult;
+}
+
+static SpecAbstract::SCAN_OPTIONS _getOptions(NFD_ENGINE *pEngine,unsigned int nOptions)
+{
+    SpecAbstract::SCAN_OPTIONS result=pEngine->options;
+    result.bRecursive=(nOptions&NFD_OPTION_RECURSIVE)?(true):(false);
+    result.bDeepScan=(nOptions&NFD_OPTION_DEEPSCAN)?(true):(false);
+    result.bMapFiles=(nOptions&NFD_OPTION_MMAP)?(true):(false);
+
+    return result;
+}
+
+static SpecAbstract::SCAN_RESULT _scanDevice(QIODevice *pDevice,SpecAbstract::SCAN_OPTIONS *pOptions)
+{
+    SpecAbstract::SCAN_RESULT result= {0};
+
+    StaticScan scan;
+    scan.setData(pDevice,pOptions,&result);
+    scan.process();
+
+    return result;
+}
+
+static SpecAbstract::SCAN_RESULT _scanMemory(const char *pData,int nSize,SpecAbstract::SCAN_OPTIONS *pOptions)
+{
+    SpecAbstract::SCAN_RESULT result= {0};
+
+    // fromRawData and a read-only QBuffer leave the data where it is; the parsers read it through XBinary::getDeviceMemory
+    QByteArray baData=QByteArray::fromRawData(pData,nSize);
+    QBuffer buffer(&baData);
+
+    if(buffer.open(QIODevice::ReadOnly))
+    {
+        result=_scanDevice(&buffer,pOptions);
+
+        buffer.close();
+    }
+
+    return result;
+}
+
+const char *nfd_get_version(void)
+{
+    return SSE_VERSION;
+}
+
+NFD_ENGINE *nfd_create(void)
+{
+    NFD_ENGINE *pEngine=new NFD_ENGINE;
+    pEngine->options=SpecAbstract::SCAN_OPTIONS();
+
+    return pEngine;
+}
+
+void nfd_destroy(NFD_ENGINE *pEngine)
+{
+    delete pEngine;
+}
+
+NFD_RESULT *nfd_scan_buffer(NFD_ENGINE *pEngine, const void *pData, size_t nSize, unsigned int nOptions)
+{
+    NFD_RESULT *pResult=nullptr;
+
+    if(pEngine&&(nSize==0))
+    {
+        SpecAbstract::SCAN_RESULT scanResult= {0};
+
+        pResult=_createResult(&scanResult);
+    }
+    else if(pEngine&&pData&&(nSize<NFD_MAXBUFFERSIZE)) // QByteArray size limit
+    {
+        SpecAbstract::SCAN_OPTIONS options=_getOptions(pEngine,nOptions);
+        SpecAbstract::SCAN_RESULT scanResult=_scanMemory((const char *)pData,(int)nSize,&options);
+
+        pResult=_createResult(&scanResult);
+    }
+
+    return pResult;
+}
+
+NFD_RESULT *nfd_scan_fd(NFD_ENGINE *pEngine, int nFd, unsigned int nOptions)
+{
+    NFD_RESULT *pResult=nullptr;
+
+    QFile file;
+
+    if(pEngine&&file.open(nFd,QIODevice::ReadOnly,QFileDevice::DontCloseHandle))
+    {
+        SpecAbstract::SCAN_OPTIONS options=_getOptions(pEngine,nOptions);
+        SpecAbstract::SCAN_RESULT scanResult= {0};
+
+        qint64 nFileSize=file.size();
+        uchar *pMemory=nullptr;
+
+        // The caller owns the file and may truncate it, so mapping is opt-in
+        if((options.bMapFiles)&&(nFileSize>0)&&(nFileSize<0x7FFFFFFF)) // QByteArray size limit
+        {
+            pMemory=file.map(0,nFileSize);
+        }
+
+        if(pMemory)
+        {
+            scanResult=_scanMemory((const char *)pMemory,(int)nFileSize,&options);
+
+            file.unmap(pMemory);
+        }
+        else
+        {
+            scanResult=_scanDevice(&file,&options);
+        }
+
+        file.close();
+
+        pResult=_createResult(&scanResult);
+    }
+
+    return pResult;
+}
+
+int nfd_result_count(const NFD_RESULT *pResult)
+{
+    int nResult=0;
+
+    if(pResult)
+    {
+        nResult=pResult->listRecords.count();
+    }
+
+    return nResult;
+}
+
+const NFD_RECORD *nfd_result_record(const NFD_RESULT *pResult, int nIndex)
+{
+    const NFD_RECORD *pRecord=nullptr;
+
+    if(pResult&&(nIndex>=0)&&(nIndex<pResult->listRecords.count()))
+    {
+        pRecord=&(pResult->listRecords.at(nIndex));
+    }
+
+    return pRecord;
+}
+
+long long nfd_result_scantime(const NFD_RESULT *pResult)
+{
+    long long nResult=0;
+
+    if(pResult)
+    {
+        nResult=pResult->nScanTime;
+    }
+
+    return nResult;
+}
+
+void nfd_result_free(NFD_RESULT *pResult)
+{
+    delete pResult;
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2018-2019 hors<horsicq@gmail.com>
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+#ifndef NFD_H
+#define NFD_H
+
+#include <stddef.h>
+
+#if defined(_WIN32)
+#ifdef NFD_LIBRARY
+#define NFD_EXPORT __declspec(dllexport)
+#else
+#define NFD_EXPORT __declspec(dllimport)
+#endif
+#else
+#define NFD_EXPORT __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define NFD_OPTION_RECURSIVE 0x00000001
+#define NFD_OPTION_DEEPSCAN 0x00000002
+#define NFD_OPTION_MMAP 0x00000004      // nfd_scan_fd maps the file; the process gets SIGBUS if it is truncated during the scan
+
+typedef struct NFD_ENGINE NFD_ENGINE;
+typedef struct NFD_RESULT NFD_RESULT;
+
+typedef struct NFD_RECORD
+{
+    const char *pszFiletype;    // "PE", "ELF", ...
+    const char *pszType;        // "compiler", "packer", ...
+    const char *pszName;
+    const char *pszVersion;
+    const char *pszInfo;
+    const char *pszString;      // type: name(version)[info]
+    long long nOffset;
+    long long nSize;
+    int nParent;                // Index of the record this one was found in, -1 for the top level
+} NFD_RECORD;
+
+// An engine may be used by several threads at once. Strings are UTF-8 and live as long as their result.
+NFD_EXPORT const char *nfd_get_version(void);
+NFD_EXPORT NFD_ENGINE *nfd_create(void);
+NFD_EXPORT void nfd_destroy(NFD_ENGINE *pEngine);
+// The buffer is read in place. nSize must be below NFD_MAXBUFFERSIZE (2 GB): a larger buffer returns NULL like a failed allocation,
+// scan it with nfd_scan_fd instead. An empty buffer (pData may be NULL) gives a result without records.
+#define NFD_MAXBUFFERSIZE 0x7FFFFFFF
+NFD_EXPORT NFD_RESULT *nfd_scan_buffer(NFD_ENGINE *pEngine,const void *pData,size_t nSize,unsigned int nOptions);
+NFD_EXPORT NFD_RESULT *nfd_scan_fd(NFD_ENGINE *pEngine,int nFd,unsigned int nOptions); // The descriptor stays open; read with read(2) unless NFD_OPTION_MMAP
+NFD_EXPORT int nfd_result_count(const NFD_RESULT *pResult);
+NFD_EXPORT const NFD_RECORD *nfd_result_record(const NFD_RESULT *pResult,int nIndex);
+NFD_EXPORT long long nfd_result_scantime(const NFD_RESULT *pResult);
+NFD_EXPORT void nfd_result_free(NFD_RESULT *pResult);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NFD_H